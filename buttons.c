@@ -0,0 +1,225 @@
+/******************************************************************************
+ *
+ * FILE: buttons.c
+ *
+ * DESCRIPTION:
+ *   Interrupt-driven input for the two LaunchPad buttons.
+ *   - The port 1 interrupt catches the first edge of a press or release,
+ *     latches its time in the reaction timer and hands the button over to
+ *     the debounce state machine.
+ *   - Every 10 ms tick the button is sampled. Once it has read the new
+ *     level for DEBOUNCE_TICKS ticks in a row, a press or release event is
+ *     queued with the time of that first edge and the CPU is woken up.
+ *   - If the button goes back to its old level instead, it was just a
+ *     glitch and the pin interrupt is armed again without an event.
+ *
+ *   While no button is moving, nothing runs at all and the game loop stays
+ *   asleep in LPM3.
+ *
+ * CREATED BY:
+ *   Hanna Szalai & Haroun Riahi
+ *
+ ******************************************************************************/
+
+#include <driverlib.h>
+#include "buttons.h"
+#include "scheduler.h"
+#include "reactionTimer.h"
+#include "profiler.h"
+
+// Number of ticks (10 ms each) a new level must be stable to count
+#define DEBOUNCE_TICKS      2
+
+// Must be a power of two
+#define EVENT_QUEUE_SIZE    8
+
+#define BUTTON_COUNT        2
+
+// Debounce states
+#define BUTTON_ARMED        0   // Waiting for an edge interrupt
+#define BUTTON_CHECKING     1   // Edge seen, sampling on every tick
+
+static const uint8_t buttonPins[BUTTON_COUNT] = { BUTTON_ONE, BUTTON_TWO };
+
+static volatile uint8_t buttonState[BUTTON_COUNT];
+static volatile uint8_t changedCount[BUTTON_COUNT];   // Ticks at the new level
+static volatile uint8_t steadyCount[BUTTON_COUNT];    // Ticks at the old level
+static volatile uint8_t heldButtons = 0;              // Debounced state
+
+static volatile uint8_t eventQueue[EVENT_QUEUE_SIZE];
+static volatile uint32_t eventTimes[EVENT_QUEUE_SIZE];
+static volatile uint8_t eventHead = 0;
+static volatile uint8_t eventTail = 0;
+static uint32_t lastEventTime = 0;
+
+// Buttons have pull-ups, so a pressed button reads low
+static uint8_t isPressed(uint8_t pin)
+{
+    return (P1IN & pin) == 0;
+}
+
+static void postEvent(uint8_t event, uint32_t time)
+{
+    uint8_t next = (eventHead + 1) & (EVENT_QUEUE_SIZE - 1);
+
+    // Drop the event if the game loop has fallen this far behind
+    if (next != eventTail)
+    {
+        eventQueue[eventHead] = event;
+        eventTimes[eventHead] = time;
+        eventHead = next;
+    }
+}
+
+// Enables the pin interrupt for the next edge the button can make
+static void armButton(uint8_t index)
+{
+    uint8_t pin = buttonPins[index];
+
+    GPIO_selectInterruptEdge(GPIO_PORT_P1, pin,
+            (heldButtons & pin) ? GPIO_LOW_TO_HIGH_TRANSITION
+                                : GPIO_HIGH_TO_LOW_TRANSITION);
+    GPIO_clearInterrupt(GPIO_PORT_P1, pin);
+    buttonState[index] = BUTTON_ARMED;
+    GPIO_enableInterrupt(GPIO_PORT_P1, pin);
+
+    // The button may have moved before the interrupt was enabled
+    if (isPressed(pin) != ((heldButtons & pin) != 0))
+    {
+        GPIO_disableInterrupt(GPIO_PORT_P1, pin);
+        reactionCaptureEdge(index);
+        changedCount[index] = 0;
+        steadyCount[index] = 0;
+        buttonState[index] = BUTTON_CHECKING;
+    }
+}
+
+void initializeButtons(void)
+{
+    uint8_t i;
+
+    // Pins are already inputs with pull-ups from initializePins()
+    for (i = 0; i < BUTTON_COUNT; i++)
+    {
+        if (isPressed(buttonPins[i]))
+        {
+            heldButtons |= buttonPins[i];
+        }
+        armButton(i);
+    }
+}
+
+uint8_t getButtonEvent(void)
+{
+    uint8_t event = BUTTON_EVENT_NONE;
+
+    if (eventTail != eventHead)
+    {
+        event = eventQueue[eventTail];
+        lastEventTime = eventTimes[eventTail];
+        eventTail = (eventTail + 1) & (EVENT_QUEUE_SIZE - 1);
+    }
+
+    return event;
+}
+
+uint32_t getButtonEventTime(void)
+{
+    return lastEventTime;
+}
+
+uint8_t waitButtonEvent(void)
+{
+    uint8_t event;
+
+    __disable_interrupt();
+    while ((event = getButtonEvent()) == BUTTON_EVENT_NONE)
+    {
+        enterSleep();
+    }
+    __enable_interrupt();
+
+    return event;
+}
+
+void flushButtonEvents(void)
+{
+    eventTail = eventHead;
+}
+
+uint8_t getHeldButtons(void)
+{
+    return heldButtons;
+}
+
+uint8_t debounceButtons(void)
+{
+    uint8_t i;
+    uint8_t pin;
+    uint8_t newEvent = 0;
+
+    for (i = 0; i < BUTTON_COUNT; i++)
+    {
+        if (buttonState[i] != BUTTON_CHECKING)
+        {
+            continue;
+        }
+
+        pin = buttonPins[i];
+
+        if (isPressed(pin) != ((heldButtons & pin) != 0))
+        {
+            // Button is at the new level
+            steadyCount[i] = 0;
+            if (++changedCount[i] >= DEBOUNCE_TICKS)
+            {
+                heldButtons ^= pin;
+                postEvent((heldButtons & pin) ? pin : (pin | BUTTON_EVENT_RELEASED),
+                          reactionCapturedTime(i));
+                newEvent = 1;
+                armButton(i);
+            }
+        }
+        else
+        {
+            // Button is back at the old level, give up after a while
+            changedCount[i] = 0;
+            if (++steadyCount[i] >= DEBOUNCE_TICKS)
+            {
+                armButton(i);
+            }
+        }
+    }
+
+    return newEvent;
+}
+
+// Port 1 Interrupt Service Routine (button edges)
+#pragma vector=PORT1_VECTOR
+__interrupt void Port_1 (void)
+{
+    uint8_t i;
+    uint8_t pin;
+    uint16_t flags;
+
+    activeTimeIsrStart();
+    PROFILE_START(PROBE_PORT1_ISR);
+    flags = GPIO_getInterruptStatus(GPIO_PORT_P1, BUTTON_ONE | BUTTON_TWO);
+
+    for (i = 0; i < BUTTON_COUNT; i++)
+    {
+        pin = buttonPins[i];
+        if (flags & pin)
+        {
+            // Ignore further bounces until the tick has checked the level
+            GPIO_disableInterrupt(GPIO_PORT_P1, pin);
+            GPIO_clearInterrupt(GPIO_PORT_P1, pin);
+            reactionCaptureEdge(i);
+            changedCount[i] = 0;
+            steadyCount[i] = 0;
+            buttonState[i] = BUTTON_CHECKING;
+        }
+    }
+    PROFILE_STOP(PROBE_PORT1_ISR);
+    activeTimeIsrEnd();
+}
@@ -0,0 +1,53 @@
+/******************************************************************************
+ *
+ * FILE: buttons.h
+ *
+ * PURPOSE:
+ *   Declares the interrupt-driven button driver. Edges on S1 (P1.1) and
+ *   S2 (P1.2) are caught by the port 1 interrupt and confirmed by a
+ *   debounce state machine that runs on the 10 ms scheduler tick.
+ *   Clean press and release events are queued for the game loop, which
+ *   sleeps in LPM3 until one arrives. Each event carries the time of its
+ *   first edge, captured by the reaction timer in the port interrupt.
+ *
+ * CREATED BY:
+ *   Hanna Szalai & Haroun Riahi
+ *
+ ******************************************************************************/
+
+#ifndef LCD_BUTTONS_H_
+#define LCD_BUTTONS_H_
+
+#include "stdint.h"
+
+// BUTTONS (pin masks on port 1)
+#define BUTTON_ONE   0x0002
+#define BUTTON_TWO  0x0004
+
+// Button events are the pin mask of the button, plus a flag for releases
+#define BUTTON_EVENT_NONE       0x00
+#define BUTTON_EVENT_RELEASED   0x80
+
+// Sets up the port 1 interrupts for both buttons
+void initializeButtons(void);
+
+// Sleeps until a button event is available and returns it
+uint8_t waitButtonEvent(void);
+
+// Returns the next button event, or BUTTON_EVENT_NONE if there is none
+uint8_t getButtonEvent(void);
+
+// Reaction timer count (reactionTimer.h) of the first edge of the event
+// last returned by waitButtonEvent or getButtonEvent
+uint32_t getButtonEventTime(void);
+
+// Throws away any events that have not been read yet
+void flushButtonEvents(void);
+
+// Returns the debounced mask of buttons currently held down
+uint8_t getHeldButtons(void);
+
+// Called from the scheduler tick; returns 1 when a new event was queued
+uint8_t debounceButtons(void);
+
+#endif
@@ -0,0 +1,122 @@
+/******************************************************************************
+ *
+ * FILE: checkpoint.c
+ *
+ * DESCRIPTION:
+ *   Double-buffered game checkpoint in FRAM (see checkpoint.h).
+ *   - Both records are persistent variables, so they keep their contents
+ *     through a reset. FRAM needs no erase, so a save is just a few word
+ *     writes into the record that does not hold the newest state.
+ *   - The CRC is written last. Until then the record fails its check and
+ *     checkpointLoad uses the other one.
+ *   - The newest record is the valid one with the higher sequence number,
+ *     compared so that the numbers can wrap around.
+ *   - A cleared checkpoint is a valid record with no game in progress,
+ *     written like any other, so it cannot bring back an older game.
+ *
+ * CREATED BY:
+ *   Hanna Szalai & Haroun Riahi
+ *
+ ******************************************************************************/
+
+#include <driverlib.h>
+#include <stddef.h>
+#include "checkpoint.h"
+
+#define RECORD_COUNT    2
+
+typedef struct
+{
+    uint16_t sequence;      // One more than the record before it
+    uint16_t active;        // 1 while a game is in progress
+    GameCheckpoint game;
+    uint16_t crc;           // CRC16 of all the words above
+} Record;
+
+// Words of a record covered by its CRC
+#define RECORD_CRC_WORDS    (offsetof(Record, crc) / sizeof(uint16_t))
+
+#pragma PERSISTENT(records)
+Record records[RECORD_COUNT] = {0};
+
+static uint16_t recordCrc(const Record *record)
+{
+    const uint16_t *word = (const uint16_t *)record;
+    uint8_t i;
+
+    CRC_setSeed(CRC_BASE, CHECKPOINT_CRC_SEED);
+    for (i = 0; i < RECORD_CRC_WORDS; i++)
+    {
+        CRC_set16BitData(CRC_BASE, word[i]);
+    }
+    return CRC_getResult(CRC_BASE);
+}
+
+// The newest record that passes its CRC check, or 0 if neither does
+static const Record *newestRecord(void)
+{
+    const Record *newest = 0;
+    uint8_t i;
+
+    for (i = 0; i < RECORD_COUNT; i++)
+    {
+        if (records[i].crc != recordCrc(&records[i]))
+        {
+            continue;
+        }
+        if (!newest || (int16_t)(records[i].sequence - newest->sequence) > 0)
+        {
+            newest = &records[i];
+        }
+    }
+    return newest;
+}
+
+static void saveRecord(uint16_t active, const GameCheckpoint *game)
+{
+    const Record *newest = newestRecord();
+    Record *record = (newest == &records[0]) ? &records[1] : &records[0];
+
+    // Spoil the record first, so it never passes with half its new contents
+    record->crc = ~recordCrc(record);
+
+    record->sequence = newest ? newest->sequence + 1 : 0;
+    record->active = active;
+    record->game = *game;
+    record->crc = recordCrc(record);
+}
+
+void checkpointSave(const GameCheckpoint *game)
+{
+    saveRecord(1, game);
+}
+
+void checkpointClear(void)
+{
+    GameCheckpoint game;
+
+    // Nothing to write if no game is in progress
+    if (checkpointLoad(&game))
+    {
+        saveRecord(0, &game);
+    }
+}
+
+uint16_t checkpointSequence(void)
+{
+    const Record *newest = newestRecord();
+
+    return newest ? newest->sequence : 0;
+}
+
+uint8_t checkpointLoad(GameCheckpoint *game)
+{
+    const Record *newest = newestRecord();
+
+    if (!newest || !newest->active)
+    {
+        return 0;
+    }
+    *game = newest->game;
+    return 1;
+}
@@ -0,0 +1,54 @@
+/******************************************************************************
+ *
+ * FILE: checkpoint.h
+ *
+ * PURPOSE:
+ *   Declares the game checkpoint: the state of the game in progress,
+ *   saved to FRAM at every round boundary so a reset or brown-out resumes
+ *   the game at the round it was in, without the intro.
+ *
+ *   The sequence itself is not saved: it is generated from its seed, so
+ *   the seed, the next round and the points are enough to rebuild it.
+ *   The pace of the difficulty engine is saved with them, so a resumed
+ *   game goes on as fast as it was.
+ *
+ *   There are two records, written in turn, each with a sequence number
+ *   and a CRC16 from the CRC module. A reset halfway through a save only
+ *   spoils the record being written; the other one still holds the
+ *   previous round.
+ *
+ * CREATED BY:
+ *   Hanna Szalai & Haroun Riahi
+ *
+ ******************************************************************************/
+
+#ifndef LCD_CHECKPOINT_H_
+#define LCD_CHECKPOINT_H_
+
+#include "stdint.h"
+
+#define CHECKPOINT_CRC_SEED     0xFFFF
+
+typedef struct
+{
+    uint16_t seed;          // Seed the sequence was started from
+    uint16_t round;         // Next round to play (counting from 0)
+    uint16_t points;        // Points so far
+    uint16_t pace;          // Q8.8 pace of the difficulty engine
+} GameCheckpoint;
+
+// Saves the game in progress
+void checkpointSave(const GameCheckpoint *game);
+
+// Ends the game in progress, so the next start shows the intro again
+void checkpointClear(void);
+
+// Number of the newest record, which names the game in progress: it only
+// changes when the game is saved again or cleared
+uint16_t checkpointSequence(void);
+
+// Copies the newest valid record into game and returns 1 if it holds a
+// game in progress, otherwise returns 0
+uint8_t checkpointLoad(GameCheckpoint *game);
+
+#endif
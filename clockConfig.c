@@ -6,14 +6,17 @@
     It configures ACLK (Auxiliary Clock), SMCLK (Sub-Main Clock), and MCLK (Main Clock)
     using the internal DCO and an external crystal oscillator (LFXT).
 
-    The function `initializeClocks()` ensures stable clock configuration using recommended
-    settings and timeout safeguards.
+    The function `initializeClocks()` sets the clocks up without waiting for
+    the crystal, and `clockTick()` moves ACLK over to it once it is stable.
 
   FUNCTIONALITY:
     - Sets external crystal frequencies
-    - Waits for LFXT (low-frequency crystal) to stabilize
+    - Starts LFXT (low-frequency crystal) and runs ACLK from LFMODCLK meanwhile
+    - Switches ACLK to LFXT when the crystal is stable, and back on a fault
     - Configures the digitally controlled oscillator (DCO)
     - Assigns clock sources to ACLK, SMCLK, and MCLK
+    - Tells the peripherals what ACLK and SMCLK really run at, and keeps
+      track of any peripheral that needs a faster clock than it got
 
   AUTHORS:
     Hanna Szalai & Haroun Riahi
@@ -22,10 +25,6 @@
 
 #include <driverlib.h>
 #include <clockConfig.h>
-#include <stdbool.h>
-
-// This sets how long we will wait for the crystal oscillator to stabilize
-#define CLOCK_TIMEOUT   100000
 
 // These variables will store the frequencies of the different system clocks
 uint32_t freqACLK    = 0;
@@ -33,8 +32,46 @@ uint32_t freqSMCLK  = 0;
 uint32_t freqMCLK    = 0;
 
 // This is used to store whether the external crystal oscillator is working properly or not
-bool isStable   = STATUS_FAIL;
-uint8_t  xtalStatus  = 0;
+static volatile uint8_t crystalState = CRYSTAL_STARTING;
+static uint16_t startTicks  = 0;     // Ticks since the crystal was started
+static uint8_t  stableTicks = 0;     // Ticks in a row without a fault
+
+// Clocks that could not give a peripheral the frequency it asked for
+static uint8_t shortfall = 0;
+
+// Peripherals to tell when a clock changes
+static ClockChanged watchers[CLOCK_MAX_WATCHERS];
+static uint8_t watcherClocks[CLOCK_MAX_WATCHERS];
+static uint8_t watcherCount = 0;
+
+// Enables the crystal with the strongest drive for a quick start, without
+// waiting for it (DriverLib only has calls that wait)
+static void startCrystal(void)
+{
+    CSCTL0_H = CSKEY_H;
+    CSCTL4 = (CSCTL4 & ~(LFXTOFF | LFXTBYPASS)) | LFXTDRIVE_3;
+    CSCTL0_H = 0;
+
+    crystalState = CRYSTAL_STARTING;
+    startTicks = 0;
+    stableTicks = 0;
+}
+
+// Gives every watcher of a clock its new frequency
+static void clockChanged(uint8_t clock)
+{
+    uint32_t hz = (clock == CLOCK_ACLK) ? CS_getACLK() : CS_getSMCLK();
+    uint8_t i;
+
+    freqACLK = CS_getACLK();
+    for (i = 0; i < watcherCount; i++)
+    {
+        if (watcherClocks[i] == clock)
+        {
+            watchers[i](hz);
+        }
+    }
+}
 
 // This function sets up the system clocks for the MSP430 (code mainly gotten from official guide)
 void initializeClocks(void) {
@@ -50,18 +87,9 @@ void initializeClocks(void) {
     freqSMCLK = CS_getSMCLK();
     freqMCLK = CS_getMCLK();
 
-    // Try to turn on the low-frequency crystal oscillator (LFXT)
-    isStable  = CS_turnOnLFXTWithTimeout(
-                  CS_LFXT_DRIVE_0,
-                  CLOCK_TIMEOUT
-              );
-
-    // If the oscillator didnt stabilize in time, go into an infinite loop (halt the system)
-    if ( isStable == STATUS_FAIL )
-    {
-        while( 1 );   // Stuck here forever  this means the clock failed to start, something's wrong!
-    }
-
+    // Start the low-frequency crystal oscillator (LFXT); clockTick switches
+    // ACLK to it once it is stable, so the boot does not wait hundreds of ms
+    startCrystal();
 
     // Set the main internal oscillator (DCO) to a specific frequency range (we picked medium-fast)
     CS_setDCOFreq(
@@ -69,10 +97,10 @@ void initializeClocks(void) {
             CS_DCOFSEL_3 // Set to 4 MHz
     );
 
-    // Set ACLK (Auxiliary Clock) to use the low-frequency external crystal (LFXT)
+    // Run ACLK (Auxiliary Clock) from LFMODCLK until the crystal is stable
     CS_initClockSignal(
             CS_ACLK,
-            CS_LFXTCLK_SELECT, // Chose the low-frequency crystal as source
+            CS_LFMODOSC_SELECT, // Internal, runs as soon as it is selected
             CS_CLOCK_DIVIDER_1 // Dont divide the clock, use it as-is
     );
 
@@ -96,3 +124,98 @@ void initializeClocks(void) {
     freqMCLK         = CS_getMCLK();
 }
 
+// Called by each peripheral's init after initializeClocks, so the
+// frequency returned is the one the clock tree really has
+uint32_t clockRequest(uint8_t clock, uint32_t minimumHz)
+{
+    uint32_t hz = (clock == CLOCK_ACLK) ? CS_getACLK() : CS_getSMCLK();
+
+    if (hz < minimumHz)
+    {
+        shortfall |= 1 << clock;
+    }
+
+    return hz;
+}
+
+uint8_t clockShortfall(void)
+{
+    return shortfall;
+}
+
+void clockWatch(uint8_t clock, ClockChanged changed)
+{
+    if (watcherCount < CLOCK_MAX_WATCHERS)
+    {
+        watcherClocks[watcherCount] = clock;
+        watchers[watcherCount] = changed;
+        watcherCount++;
+    }
+}
+
+uint8_t clockCrystalState(void)
+{
+    return crystalState;
+}
+
+// The fault flag of the crystal comes back right after it is cleared for as
+// long as the crystal is not running properly, so a tick that finds it
+// clear means the crystal ran for the whole tick
+void clockTick(void)
+{
+    if (crystalState != CRYSTAL_STARTING)
+    {
+        return;
+    }
+
+    startTicks++;
+    if (CS_getFaultFlagStatus(CS_LFXTOFFG))
+    {
+        CS_clearFaultFlag(CS_LFXTOFFG);
+        SFR_clearInterrupt(SFR_OSCILLATOR_FAULT_INTERRUPT);
+        stableTicks = 0;
+
+        // No crystal, or a broken one: stay on LFMODCLK for good
+        if (startTicks >= LFXT_START_TICKS)
+        {
+            CS_turnOffLFXT();
+            CS_clearFaultFlag(CS_LFXTOFFG);
+            SFR_clearInterrupt(SFR_OSCILLATOR_FAULT_INTERRUPT);
+            crystalState = CRYSTAL_FAILED;
+        }
+        return;
+    }
+
+    if (++stableTicks < LFXT_STABLE_TICKS)
+    {
+        return;
+    }
+
+    // Stable: back to the lowest drive, as CS_turnOnLFXTWithTimeout did
+    CSCTL0_H = CSKEY_H;
+    CSCTL4 = (CSCTL4 & ~LFXTDRIVE_3) | CS_LFXT_DRIVE_0;
+    CSCTL0_H = 0;
+
+    CS_initClockSignal(CS_ACLK, CS_LFXTCLK_SELECT, CS_CLOCK_DIVIDER_1);
+    crystalState = CRYSTAL_RUNNING;
+    clockChanged(CLOCK_ACLK);
+
+    // From now on a crystal fault raises the oscillator fault interrupt
+    SFR_clearInterrupt(SFR_OSCILLATOR_FAULT_INTERRUPT);
+    SFR_enableInterrupt(SFR_OSCILLATOR_FAULT_INTERRUPT);
+}
+
+// Oscillator fault Interrupt Service Routine (the crystal stopped)
+#pragma vector=UNMI_VECTOR
+__interrupt void UNMI_ISR (void)
+{
+    // The CS has already switched ACLK to LFMODCLK; make that the setting
+    // and wait for the crystal in clockTick again
+    SFR_disableInterrupt(SFR_OSCILLATOR_FAULT_INTERRUPT);
+    CS_initClockSignal(CS_ACLK, CS_LFMODOSC_SELECT, CS_CLOCK_DIVIDER_1);
+    CS_clearFaultFlag(CS_LFXTOFFG);
+    SFR_clearInterrupt(SFR_OSCILLATOR_FAULT_INTERRUPT);
+
+    startCrystal();
+    clockChanged(CLOCK_ACLK);
+}
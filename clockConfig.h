@@ -9,6 +9,20 @@
  *   To set up a reliable clock system for the MSP430 so other parts of
  *   the program (like timers or delays) will work accurately.
  *
+ *   initializeClocks is the only code that writes the CS registers. The
+ *   peripherals ask for the clock they run from with clockRequest and
+ *   work out their dividers from the frequency it returns, so changing
+ *   the clock tree here keeps the tick, the LCD and the baud rate right.
+ *
+ *   ACLK starts on the internal LFMODCLK, so nothing waits for the 32768 Hz
+ *   crystal at boot. The scheduler tick calls clockTick, which moves ACLK
+ *   over to the crystal once it has run without a fault for a while, or
+ *   turns the crystal off if it never does. A crystal that stops later
+ *   raises the oscillator fault interrupt, which puts ACLK back on
+ *   LFMODCLK and starts watching the crystal again. Each time ACLK
+ *   changes, the peripherals that asked for it with clockWatch are told
+ *   its new frequency.
+ *
  * AUTHORS:
  *   Hanna Szalai & Haroun Riahi
  *
@@ -17,8 +31,47 @@
 #ifndef LCD_CLOCKCONFIG_H_
 #define LCD_CLOCKCONFIG_H_
 
+#include "stdint.h"
+
 // It initializes the internal and external clocks to the desired speeds.
-void setupSystemClocks(void);
+void initializeClocks(void);
+
+// Clocks a peripheral can ask for
+#define CLOCK_ACLK      0
+#define CLOCK_SMCLK     1
+
+// A peripheral says it runs from this clock and needs at least minimumHz.
+// Returns the frequency the clock really has, to derive dividers from.
+uint32_t clockRequest(uint8_t clock, uint32_t minimumHz);
+
+// One bit per clock (1 << CLOCK_x) that was slower than a request asked for
+uint8_t clockShortfall(void);
+
+// Called with the new frequency of a clock after it changed. Runs in an
+// interrupt (the scheduler tick or the oscillator fault).
+typedef void (*ClockChanged)(uint32_t hz);
+
+// Most peripherals that can watch the clocks
+#define CLOCK_MAX_WATCHERS  4
+
+// A peripheral that set itself up from clockRequest asks to be told when
+// the clock changes, so it can work out its dividers again
+void clockWatch(uint8_t clock, ClockChanged changed);
+
+// Watches the crystal start; called from the scheduler tick
+void clockTick(void);
+
+// Scheduler ticks the crystal must run without a fault before ACLK moves
+// to it, and ticks after which it is given up
+#define LFXT_STABLE_TICKS   5
+#define LFXT_START_TICKS    300
+
+// States of the crystal
+#define CRYSTAL_STARTING    0
+#define CRYSTAL_RUNNING     1
+#define CRYSTAL_FAILED      2
+
+uint8_t clockCrystalState(void);
 
 // These values tell the MSP430 the speed of the crystal we're using
 #define HIGH_FREQ_CRYSTAL_HZ 0
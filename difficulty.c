@@ -0,0 +1,161 @@
+/******************************************************************************
+ *
+ * FILE: difficulty.c
+ *
+ * DESCRIPTION:
+ *   Adaptive pace of the game (see difficulty.h).
+ *   - paceTable holds the durations of the first rounds; later rounds
+ *     use its last entry.
+ *   - The average reaction time and the rate of lost rounds are moving
+ *     averages that weigh each new sample 1/8: new = (7 * old + sample) / 8,
+ *     a multiply and a shift.
+ *   - After a won round the pace is multiplied by 15/16 if the player
+ *     reacts faster than DIFFICULTY_FAST_MS on average, or by 17/16 if
+ *     slower than DIFFICULTY_SLOW_MS. A lost round multiplies it by
+ *     1 + 1/16 + half the rate of lost rounds.
+ *   - Reaction times are taken in milliseconds straight from the reaction
+ *     timer, which converts its counts with a multiply and a shift.
+ *
+ * CREATED BY:
+ *   Hanna Szalai & Haroun Riahi
+ *
+ ******************************************************************************/
+
+#include <driverlib.h>
+#include "difficulty.h"
+#include "reactionTimer.h"
+
+#define PACE_TABLE_ROUNDS   16
+
+// Q8.8 factors the pace is multiplied by
+#define PACE_FASTER         240     // 15/16
+#define PACE_SLOWER         272     // 17/16
+
+// Moving averages weigh the old value 7/8
+#define AVERAGE_OLD         7
+#define AVERAGE_SHIFT       3
+
+typedef struct
+{
+    uint8_t onTicks;        // LED on
+    uint8_t gapTicks;       // LEDs off before it
+    uint8_t bannerTicks;    // Each level banner
+} RoundPace;
+
+static const RoundPace paceTable[PACE_TABLE_ROUNDS] =
+{
+    { 25, 25, 30 }, { 24, 24, 29 }, { 23, 23, 28 }, { 22, 22, 27 },
+    { 21, 21, 26 }, { 20, 20, 25 }, { 19, 19, 24 }, { 18, 18, 23 },
+    { 17, 17, 22 }, { 16, 16, 21 }, { 15, 15, 20 }, { 14, 14, 19 },
+    { 14, 13, 18 }, { 13, 12, 17 }, { 13, 11, 16 }, { 12, 10, 15 }
+};
+
+static uint16_t pace = DIFFICULTY_ONE;                          // Q8.8
+static uint16_t reactionAverage = (DIFFICULTY_FAST_MS + DIFFICULTY_SLOW_MS) / 2;
+static uint16_t lostAverage = 0;                                // Q0.16
+
+// Q8.8 product, rounded
+static uint16_t scale(uint16_t value, uint16_t factor)
+{
+    return (uint16_t)(((uint32_t)value * factor + DIFFICULTY_ONE / 2) >> 8);
+}
+
+static uint16_t average(uint16_t old, uint16_t sample)
+{
+    return (uint16_t)(((uint32_t)old * AVERAGE_OLD + sample) >> AVERAGE_SHIFT);
+}
+
+static const RoundPace *roundPace(uint16_t round)
+{
+    return &paceTable[round < PACE_TABLE_ROUNDS ? round : PACE_TABLE_ROUNDS - 1];
+}
+
+static uint16_t paced(uint8_t ticks, uint16_t minimum)
+{
+    uint16_t scaled = scale(ticks, pace);
+
+    return scaled < minimum ? minimum : scaled;
+}
+
+void difficultyNewGame(void)
+{
+    pace = (pace + DIFFICULTY_ONE) >> 1;
+}
+
+void difficultyRoundEnd(uint8_t failed)
+{
+    uint16_t presses = reactionPressCount();
+    uint32_t sample;
+    uint16_t i;
+
+    if (presses > REACTION_MAX_PRESSES)
+    {
+        presses = REACTION_MAX_PRESSES;
+    }
+    for (i = 0; i < presses; i++)
+    {
+        sample = reactionTimeMs(i);
+        reactionAverage = average(reactionAverage, sample > 0xFFFF ? 0xFFFF : (uint16_t)sample);
+    }
+    lostAverage = average(lostAverage, failed ? 0xFFFF : 0);
+
+    if (failed)
+    {
+        pace = scale(pace, PACE_SLOWER + (lostAverage >> 9));
+    }
+    else if (reactionAverage < DIFFICULTY_FAST_MS)
+    {
+        pace = scale(pace, PACE_FASTER);
+    }
+    else if (reactionAverage > DIFFICULTY_SLOW_MS)
+    {
+        pace = scale(pace, PACE_SLOWER);
+    }
+
+    if (pace < DIFFICULTY_MIN_PACE)
+    {
+        pace = DIFFICULTY_MIN_PACE;
+    }
+    else if (pace > DIFFICULTY_MAX_PACE)
+    {
+        pace = DIFFICULTY_MAX_PACE;
+    }
+}
+
+uint16_t difficultyOnTicks(uint16_t round)
+{
+    return paced(roundPace(round)->onTicks, DIFFICULTY_MIN_ON);
+}
+
+uint16_t difficultyGapTicks(uint16_t round)
+{
+    return paced(roundPace(round)->gapTicks, DIFFICULTY_MIN_GAP);
+}
+
+uint16_t difficultyBannerTicks(uint16_t round)
+{
+    return paced(roundPace(round)->bannerTicks, DIFFICULTY_MIN_BANNER);
+}
+
+uint16_t difficultyPacePercent(void)
+{
+    return scale(pace, 100);
+}
+
+uint16_t difficultyPace(void)
+{
+    return pace;
+}
+
+void difficultyRestorePace(uint16_t saved)
+{
+    if (saved < DIFFICULTY_MIN_PACE)
+    {
+        saved = DIFFICULTY_MIN_PACE;
+    }
+    else if (saved > DIFFICULTY_MAX_PACE)
+    {
+        saved = DIFFICULTY_MAX_PACE;
+    }
+    pace = saved;
+}
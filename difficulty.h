@@ -0,0 +1,74 @@
+/******************************************************************************
+ *
+ * FILE: difficulty.h
+ *
+ * PURPOSE:
+ *   Declares the difficulty engine, which sets the pace of the game: how
+ *   long each LED of the playback stays on, the gap before it and how
+ *   long the level banners stay up.
+ *
+ *   The durations of a round come from a table that gets shorter round
+ *   by round. All of them are then scaled by the pace, a fixed-point
+ *   factor that follows the player: it goes down (faster) while their
+ *   reaction times are short, up when they are slow, and up by more the
+ *   more rounds they have been losing lately. A new game starts halfway
+ *   between the last pace and the table's.
+ *
+ *   The pace is Q8.8 (DIFFICULTY_ONE is the table speed) and the averages
+ *   are kept with multiplies and shifts only: the products are 16 x 16
+ *   bits, which the compiler does on MPY32 (--use_hw_mpy=F5), and
+ *   nothing is divided. The reaction times come in as milliseconds, which
+ *   the reaction timer also gets with a fixed-point multiply.
+ *
+ * CREATED BY:
+ *   Hanna Szalai & Haroun Riahi
+ *
+ ******************************************************************************/
+
+#ifndef LCD_DIFFICULTY_H_
+#define LCD_DIFFICULTY_H_
+
+#include "stdint.h"
+
+// Pace of the table, in Q8.8, and the limits of the pace
+#define DIFFICULTY_ONE          256
+#define DIFFICULTY_MIN_PACE     128     // Twice as fast as the table
+#define DIFFICULTY_MAX_PACE     384     // One and a half times as slow
+
+// Average reaction time (ms) under which the game speeds up, and over
+// which it slows down
+#define DIFFICULTY_FAST_MS      300
+#define DIFFICULTY_SLOW_MS      600
+
+// Shortest durations, in 10 ms ticks, whatever the pace. The on and gap
+// floors are the last entries of the table, so the table's own curve is
+// never cut off at pace 1.0.
+#define DIFFICULTY_MIN_ON       12
+#define DIFFICULTY_MIN_GAP      10
+#define DIFFICULTY_MIN_BANNER   10
+
+// A new game eases the pace halfway back to the table's
+void difficultyNewGame(void);
+
+// Takes in the reaction times of the round just played (from the reaction
+// timer) and whether it was lost, and adjusts the pace
+void difficultyRoundEnd(uint8_t failed);
+
+// Ticks an LED of the playback stays on in a round (counting from 0)
+uint16_t difficultyOnTicks(uint16_t round);
+
+// Ticks with the LEDs off before each LED of the playback
+uint16_t difficultyGapTicks(uint16_t round);
+
+// Ticks each level banner stays up
+uint16_t difficultyBannerTicks(uint16_t round);
+
+// Pace as a percentage of the table's time (100 = table speed)
+uint16_t difficultyPacePercent(void);
+
+// The Q8.8 pace, for the game checkpoint, and setting it back when a
+// game is resumed (kept within the pace limits)
+uint16_t difficultyPace(void);
+void difficultyRestorePace(uint16_t saved);
+
+#endif
@@ -16,12 +16,6 @@
 #include <driverlib.h>
 #include "gpioSetup.h"
 
-#define GREEN_ON 0x0080
-#define GREEN_OFF 0xFF7F
-
-#define RED_ON   0x0001
-#define RED_OFF  0xFFFE
-
 #define ENABLE_PINS  0xFFFE
 
 #define BUTTON_ONE	0x0002
@@ -4,7 +4,8 @@
  *
  * PURPOSE:
  *   This header file declares the function responsible for setting up all
- *   the input and output pins used in the memory game on the MSP430.
+ *   the input and output pins used in the memory game on the MSP430, and
+ *   the pin masks of the two LEDs.
  *
  * CREATED BY:
  *   Hanna Szalai & Haroun Riahi
@@ -14,8 +15,16 @@
 #ifndef LCD_GPIOSETUP_H_
 #define LCD_GPIOSETUP_H_
 
+// RED LED (P1.0)
+#define RED_ON    0x0001
+#define RED_OFF   0xFFFE
+
+// GREEN LED (P9.7)
+#define GREEN_ON  0x0080
+#define GREEN_OFF 0xFF7F
+
 // This function sets up LEDs, buttons, and oscillator input pins
-void setupGPIO(void);
+void initializePins(void);
 
 #endif
 
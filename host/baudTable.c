@@ -0,0 +1,155 @@
+/******************************************************************************
+ *
+ * FILE: host/baudTable.c
+ *
+ * DESCRIPTION:
+ *   Runs uartComputeBaud (uartBaud.c) for every standard baud rate at
+ *   1, 4, 8 and 16 MHz and prints the eUSCI_A settings it picks with their
+ *   worst transmit bit error. Each result is checked against the user's
+ *   guide formulas worked out again here in floating point:
+ *   - UCOS16, UCBRx and UCBRFx must follow from N = fBRCLK / baud
+ *   - the bit error must match a frame timed with the chosen UCBRSx
+ *   - a rate is only refused when it is too fast for the clock or its
+ *     error is over UART_MAX_BIT_ERROR
+ *   Any mismatch makes the program exit with 1.
+ *
+ * BUILD AND RUN (from the repository root):
+ *   gcc -O2 -DHAL_HOST -Ihost -I. uartBaud.c host/baudTable.c -lm -o baudTable
+ *   ./baudTable
+ *
+ * CREATED BY:
+ *   Hanna Szalai & Haroun Riahi
+ *
+ ******************************************************************************/
+
+#ifdef HAL_HOST
+
+#include <math.h>
+#include <stdio.h>
+#include "uart.h"
+
+#define FRAME_BITS      10
+
+static const uint32_t clocks[] = { 1000000, 4000000, 8000000, 16000000 };
+
+static const uint32_t rates[] =
+{
+    1200, 2400, 4800, 9600, 19200, 38400, 57600, 115200,
+    230400, 460800, 921600, 1000000
+};
+
+#define COUNT(array)    (sizeof(array) / sizeof(array[0]))
+
+// Worst error of a frame in thousandths of a bit, in floating point
+static double frameError(uint32_t clockHz, uint32_t baud, const UartBaudSetting *setting)
+{
+    double bitTime = (double)clockHz / baud;
+    double elapsed = 0;
+    double worst = 0;
+    uint32_t bitClocks = setting->brw;
+    uint8_t pattern = setting->mctlw >> 8;
+    int bit;
+
+    if (setting->mctlw & 0x0001)
+    {
+        bitClocks = bitClocks * 16 + ((setting->mctlw >> 4) & 0x0F);
+    }
+
+    for (bit = 0; bit < FRAME_BITS; bit++)
+    {
+        elapsed += bitClocks + ((pattern >> (bit % 8)) & 1);
+        worst = fmax(worst, fabs(elapsed - (bit + 1) * bitTime) / bitTime * 1000);
+    }
+    return worst;
+}
+
+// Checks one result; returns the number of problems found
+static int check(uint32_t clockHz, uint32_t baud, uint8_t result, const UartBaudSetting *setting)
+{
+    double n = (double)clockHz / baud;
+    int problems = 0;
+
+    if (result != UART_OK)
+    {
+        if (n >= 3 && setting->maxError <= UART_MAX_BIT_ERROR)
+        {
+            printf("    refused, but N = %.2f and the error is %u\n", n, setting->maxError);
+            problems++;
+        }
+        return problems;
+    }
+
+    if ((n >= 16) != ((setting->mctlw & 0x0001) != 0))
+    {
+        printf("    UCOS16 does not fit N = %.2f\n", n);
+        problems++;
+    }
+    if (n >= 16)
+    {
+        if (setting->brw != (uint16_t)(n / 16)
+            || ((setting->mctlw >> 4) & 0x0F) != (uint16_t)((n / 16 - floor(n / 16)) * 16))
+        {
+            printf("    UCBRx/UCBRFx do not follow from N = %.2f\n", n);
+            problems++;
+        }
+    }
+    else if (setting->brw != (uint16_t)n)
+    {
+        printf("    UCBRx does not follow from N = %.2f\n", n);
+        problems++;
+    }
+    if (fabs(frameError(clockHz, baud, setting) - setting->maxError) > 1.0)
+    {
+        printf("    error %u, but the frame is %.1f off\n", setting->maxError,
+               frameError(clockHz, baud, setting));
+        problems++;
+    }
+    if (setting->maxError > UART_MAX_BIT_ERROR)
+    {
+        printf("    accepted with an error over %d\n", UART_MAX_BIT_ERROR);
+        problems++;
+    }
+    return problems;
+}
+
+int main(void)
+{
+    UartBaudSetting setting;
+    uint8_t result;
+    int problems = 0;
+    unsigned int c;
+    unsigned int r;
+
+    printf("    clock     baud  UCOS16  UCBRx  UCBRFx  UCBRSx  error (%% of a bit)\n");
+    for (c = 0; c < COUNT(clocks); c++)
+    {
+        for (r = 0; r < COUNT(rates); r++)
+        {
+            setting.maxError = 0xFFFF;
+            result = uartComputeBaud(clocks[c], rates[r], &setting);
+            if (result == UART_OK)
+            {
+                printf("%9lu %8lu %7u %6u %7u    0x%02X  %5.1f\n",
+                       (unsigned long)clocks[c], (unsigned long)rates[r],
+                       setting.mctlw & 0x0001, setting.brw, (setting.mctlw >> 4) & 0x0F,
+                       setting.mctlw >> 8, setting.maxError / 10.0);
+            }
+            else if (setting.maxError != 0xFFFF)
+            {
+                printf("%9lu %8lu  refused, best error %.1f\n", (unsigned long)clocks[c],
+                       (unsigned long)rates[r], setting.maxError / 10.0);
+            }
+            else
+            {
+                printf("%9lu %8lu  refused, clock too slow\n", (unsigned long)clocks[c],
+                       (unsigned long)rates[r]);
+            }
+            problems += check(clocks[c], rates[r], result, &setting);
+        }
+    }
+
+    printf("\n%d problem%s\n", problems, problems == 1 ? "" : "s");
+    return problems ? 1 : 0;
+}
+
+#endif
@@ -0,0 +1,554 @@
+/******************************************************************************
+ *
+ * FILE: host/driverlibHost.c
+ *
+ * DESCRIPTION:
+ *   Linux versions of the DriverLib calls the game makes. The real
+ *   DriverLib reaches registers through fixed 16-bit addresses, which
+ *   cannot work in a Linux process, so these functions do the same
+ *   register updates on the simulated address space from host/msp430.h.
+ *
+ *   Only the GPIO, CS, SFR, LCD_C, DMA, CRC, MPU, FRAMCtl and eUSCI_A
+ *   functions used by the game are here.
+ *
+ * CREATED BY:
+ *   Hanna Szalai & Haroun Riahi
+ *
+ ******************************************************************************/
+
+#ifdef HAL_HOST
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <driverlib.h>
+
+#define HOST_REG8(addr)     SFR_8BIT((uint16_t)(addr))
+#define HOST_REG16(addr)    SFR_16BIT((uint16_t)(addr))
+
+// Port register offsets (from the byte address of the port)
+#define PORT_IN     0x00
+#define PORT_OUT    0x02
+#define PORT_DIR    0x04
+#define PORT_REN    0x06
+#define PORT_SEL0   0x0A
+#define PORT_SEL1   0x0C
+#define PORT_IES    0x18
+#define PORT_IE     0x1A
+#define PORT_IFG    0x1C
+
+// Returns the byte address of an 8-bit port (P1, P2, ... PJ)
+static uint16_t portAddress(uint8_t port)
+{
+    if (port == GPIO_PORT_PJ)
+    {
+        return __MSP430_BASEADDRESS_PORTJ_R__;
+    }
+
+    // Ports come in pairs: odd ports are the low byte, even ports the high byte
+    return __MSP430_BASEADDRESS_PORT1_R__ + ((port - 1) / 2) * 0x20 + ((port - 1) % 2);
+}
+
+/************************************************************
+* GPIO
+************************************************************/
+
+void GPIO_setAsPeripheralModuleFunctionInputPin(uint8_t selectedPort,
+                                                uint16_t selectedPins,
+                                                uint8_t mode)
+{
+    uint16_t port = portAddress(selectedPort);
+
+    HOST_REG8(port + PORT_DIR) &= ~selectedPins;
+    if (mode & 0x01)
+    {
+        HOST_REG8(port + PORT_SEL0) |= selectedPins;
+    }
+    else
+    {
+        HOST_REG8(port + PORT_SEL0) &= ~selectedPins;
+    }
+    if (mode & 0x10)
+    {
+        HOST_REG8(port + PORT_SEL1) |= selectedPins;
+    }
+    else
+    {
+        HOST_REG8(port + PORT_SEL1) &= ~selectedPins;
+    }
+}
+
+void GPIO_enableInterrupt(uint8_t selectedPort, uint16_t selectedPins)
+{
+    HOST_REG8(portAddress(selectedPort) + PORT_IE) |= selectedPins;
+}
+
+void GPIO_disableInterrupt(uint8_t selectedPort, uint16_t selectedPins)
+{
+    HOST_REG8(portAddress(selectedPort) + PORT_IE) &= ~selectedPins;
+}
+
+uint16_t GPIO_getInterruptStatus(uint8_t selectedPort, uint16_t selectedPins)
+{
+    return HOST_REG8(portAddress(selectedPort) + PORT_IFG) & selectedPins;
+}
+
+void GPIO_clearInterrupt(uint8_t selectedPort, uint16_t selectedPins)
+{
+    HOST_REG8(portAddress(selectedPort) + PORT_IFG) &= ~selectedPins;
+}
+
+void GPIO_selectInterruptEdge(uint8_t selectedPort, uint16_t selectedPins,
+                              uint8_t edgeSelect)
+{
+    if (edgeSelect == GPIO_HIGH_TO_LOW_TRANSITION)
+    {
+        HOST_REG8(portAddress(selectedPort) + PORT_IES) |= selectedPins;
+    }
+    else
+    {
+        HOST_REG8(portAddress(selectedPort) + PORT_IES) &= ~selectedPins;
+    }
+}
+
+/************************************************************
+* CS
+************************************************************/
+
+static uint32_t lfxtFrequency = 0;
+
+void CS_setExternalClockSource(uint32_t LFXTCLK_frequency,
+                               uint32_t HFXTCLK_frequency)
+{
+    lfxtFrequency = LFXTCLK_frequency;
+}
+
+// halHost.c sets the fault flag at every tick until the crystal runs
+uint8_t CS_getFaultFlagStatus(uint8_t mask)
+{
+    return CSCTL5 & mask;
+}
+
+void CS_clearFaultFlag(uint8_t mask)
+{
+    CSCTL5 &= ~mask;
+}
+
+void CS_turnOffLFXT(void)
+{
+    CSCTL4 |= LFXTOFF;
+}
+
+void CS_setDCOFreq(uint16_t dcorsel, uint16_t dcofsel)
+{
+    CSCTL1 = dcorsel | dcofsel;
+}
+
+void CS_initClockSignal(uint8_t selectedClockSignal, uint16_t clockSource,
+                        uint16_t clockSourceDivider)
+{
+    switch (selectedClockSignal)
+    {
+    case CS_ACLK:
+        CSCTL2 = (CSCTL2 & ~0x0700) | (clockSource << 8);
+        CSCTL3 = (CSCTL3 & ~0x0700) | (clockSourceDivider << 8);
+        break;
+    case CS_SMCLK:
+        CSCTL2 = (CSCTL2 & ~0x0070) | (clockSource << 4);
+        CSCTL3 = (CSCTL3 & ~0x0070) | (clockSourceDivider << 4);
+        break;
+    case CS_MCLK:
+        CSCTL2 = (CSCTL2 & ~0x0007) | clockSource;
+        CSCTL3 = (CSCTL3 & ~0x0007) | clockSourceDivider;
+        break;
+    }
+}
+
+// DCO frequencies for DCOFSEL 0-6 with DCORSEL clear and set
+static const uint32_t dcoFrequency[2][8] =
+{
+    { 1000000, 2670000, 3330000, 4000000, 5330000, 6670000, 8000000, 8000000 },
+    { 1000000, 5330000, 6670000, 8000000, 16000000, 21000000, 24000000, 24000000 }
+};
+
+// Frequency of a clock source selected by a 3-bit SELx field
+static uint32_t sourceFrequency(uint16_t select)
+{
+    switch (select)
+    {
+    // LFXTCLK, which the CS replaces by LFMODCLK while the crystal has a fault
+    case 0:  return (CSCTL5 & LFXTOFFG) ? 39000 : (lfxtFrequency ? lfxtFrequency : 32768);
+    case 1:  return 9400;                                     // VLOCLK
+    case 2:  return 39000;                                    // LFMODCLK
+    case 3:  return dcoFrequency[(CSCTL1 & DCORSEL) != 0][(CSCTL1 >> 1) & 0x07];
+    case 4:  return 5000000;                                  // MODCLK
+    default: return 0;
+    }
+}
+
+uint32_t CS_getACLK(void)
+{
+    return sourceFrequency((CSCTL2 >> 8) & 0x07) >> ((CSCTL3 >> 8) & 0x07);
+}
+
+uint32_t CS_getSMCLK(void)
+{
+    return sourceFrequency((CSCTL2 >> 4) & 0x07) >> ((CSCTL3 >> 4) & 0x07);
+}
+
+uint32_t CS_getMCLK(void)
+{
+    return sourceFrequency(CSCTL2 & 0x07) >> (CSCTL3 & 0x07);
+}
+
+/************************************************************
+* SFR
+************************************************************/
+
+void SFR_enableInterrupt(uint8_t interruptMask)
+{
+    SFRIE1 |= interruptMask;
+}
+
+void SFR_disableInterrupt(uint8_t interruptMask)
+{
+    SFRIE1 &= ~interruptMask;
+}
+
+void SFR_clearInterrupt(uint8_t interruptFlagMask)
+{
+    SFRIFG1 &= ~interruptFlagMask;
+}
+
+/************************************************************
+* LCD_C
+************************************************************/
+
+void LCD_C_init(uint16_t baseAddress, LCD_C_initParam *initParams)
+{
+    HOST_REG16(baseAddress + OFS_LCDCCTL0) &= ~LCDON;
+    HOST_REG16(baseAddress + OFS_LCDCCTL0) = initParams->clockSource
+                                           | initParams->clockDivider
+                                           | initParams->clockPrescalar
+                                           | initParams->muxRate
+                                           | initParams->waveforms
+                                           | initParams->segments;
+}
+
+void LCD_C_on(uint16_t baseAddress)
+{
+    HOST_REG16(baseAddress + OFS_LCDCCTL0) |= LCDON;
+}
+
+void LCD_C_off(uint16_t baseAddress)
+{
+    HOST_REG16(baseAddress + OFS_LCDCCTL0) &= ~LCDON;
+}
+
+void LCD_C_clearMemory(uint16_t baseAddress)
+{
+    uint8_t i;
+
+    for (i = 0; i < 32; i++)
+    {
+        HOST_REG8(baseAddress + OFS_LCDM1 + i) = 0;
+    }
+}
+
+void LCD_C_clearBlinkingMemory(uint16_t baseAddress)
+{
+    uint8_t i;
+
+    for (i = 0; i < 32; i++)
+    {
+        HOST_REG8(baseAddress + OFS_LCDBM1 + i) = 0;
+    }
+}
+
+// LCDDISP can only be set while blinking is disabled
+void LCD_C_selectDisplayMemory(uint16_t baseAddress, uint16_t displayMemory)
+{
+    HOST_REG16(baseAddress + OFS_LCDCMEMCTL) &= ~LCDDISP;
+    if (!(HOST_REG16(baseAddress + OFS_LCDCBLKCTL) & LCDBLKMOD_3))
+    {
+        HOST_REG16(baseAddress + OFS_LCDCMEMCTL) |= displayMemory;
+    }
+}
+
+void LCD_C_setBlinkingControl(uint16_t baseAddress, uint8_t clockDivider,
+                              uint8_t clockPrescalar, uint8_t mode)
+{
+    HOST_REG16(baseAddress + OFS_LCDCBLKCTL) = clockDivider | clockPrescalar | mode;
+
+    // Blinking individual or all segments shows LCDMEM and clears LCDDISP
+    if (mode == LCDBLKMOD_1 || mode == LCDBLKMOD_2)
+    {
+        HOST_REG16(baseAddress + OFS_LCDCMEMCTL) &= ~LCDDISP;
+    }
+}
+
+void LCD_C_enableChargePump(uint16_t baseAddress)
+{
+    HOST_REG16(baseAddress + OFS_LCDCVCTL) |= LCDCPEN;
+}
+
+void LCD_C_selectChargePumpReference(uint16_t baseAddress, uint16_t reference)
+{
+}
+
+void LCD_C_setVLCDSource(uint16_t baseAddress, uint16_t vlcdSource,
+                         uint16_t v2v3v4Source, uint16_t v5Source)
+{
+}
+
+void LCD_C_setVLCDVoltage(uint16_t baseAddress, uint16_t voltage)
+{
+}
+
+void LCD_C_configChargePump(uint16_t baseAddress, uint16_t syncToClock,
+                            uint16_t functionControl)
+{
+}
+
+void LCD_C_setPinAsLCDFunctionEx(uint16_t baseAddress, uint8_t startPin,
+                                 uint8_t endPin)
+{
+}
+
+// Same nibble update as DriverLib for static to 4-mux displays
+void LCD_C_setMemory(uint16_t baseAddress, uint8_t pin, uint8_t value)
+{
+    uint8_t muxRate = HOST_REG16(baseAddress + OFS_LCDCCTL0)
+                      & (LCDMX2 | LCDMX1 | LCDMX0);
+
+    if (muxRate <= (LCDMX1 | LCDMX0))
+    {
+        if (pin & 1)
+        {
+            HOST_REG8(baseAddress + OFS_LCDM1 + pin / 2) &= 0x0F;
+            HOST_REG8(baseAddress + OFS_LCDM1 + pin / 2) |= (value & 0xF) << 4;
+        }
+        else
+        {
+            HOST_REG8(baseAddress + OFS_LCDM1 + pin / 2) &= 0xF0;
+            HOST_REG8(baseAddress + OFS_LCDM1 + pin / 2) |= (value & 0xF);
+        }
+    }
+    else
+    {
+        HOST_REG8(baseAddress + OFS_LCDM1 + pin) = value;
+    }
+}
+
+/************************************************************
+* DMA
+************************************************************/
+
+// DMA addresses are kept as two 16-bit halves, like DMAxSAL/DMAxSAH
+static void setDmaAddress(uint16_t address, uint32_t value)
+{
+    HOST_REG16(address) = (uint16_t)value;
+    HOST_REG16(address + 2) = (uint16_t)(value >> 16);
+}
+
+void DMA_init(DMA_initParam *param)
+{
+    uint16_t control = DMA_BASE + param->channelSelect + OFS_DMA0CTL;
+    uint16_t trigger = DMA_BASE + ((param->channelSelect >> 4) & 0x0E);
+
+    HOST_REG16(control) = param->transferModeSelect | param->transferUnitSelect
+                          | param->triggerTypeSelect;
+    HOST_REG16(DMA_BASE + param->channelSelect + OFS_DMA0SZ) = param->transferSize;
+
+    // Odd channels take the high byte of the trigger select register
+    if ((param->channelSelect >> 4) & 0x01)
+    {
+        HOST_REG16(trigger) = (HOST_REG16(trigger) & 0x00FF) | (param->triggerSourceSelect << 8);
+    }
+    else
+    {
+        HOST_REG16(trigger) = (HOST_REG16(trigger) & 0xFF00) | param->triggerSourceSelect;
+    }
+}
+
+void DMA_setTransferSize(uint8_t channelSelect, uint16_t transferSize)
+{
+    HOST_REG16(DMA_BASE + channelSelect + OFS_DMA0SZ) = transferSize;
+}
+
+void DMA_setSrcAddress(uint8_t channelSelect, uint32_t srcAddress,
+                       uint16_t directionSelect)
+{
+    uint16_t control = DMA_BASE + channelSelect + OFS_DMA0CTL;
+
+    setDmaAddress(DMA_BASE + channelSelect + OFS_DMA0SA, srcAddress);
+    HOST_REG16(control) = (HOST_REG16(control) & ~DMASRCINCR_3) | directionSelect;
+}
+
+void DMA_setDstAddress(uint8_t channelSelect, uint32_t dstAddress,
+                       uint16_t directionSelect)
+{
+    uint16_t control = DMA_BASE + channelSelect + OFS_DMA0CTL;
+
+    setDmaAddress(DMA_BASE + channelSelect + OFS_DMA0DA, dstAddress);
+    HOST_REG16(control) = (HOST_REG16(control) & ~DMADSTINCR_3) | (directionSelect << 2);
+}
+
+void DMA_enableTransfers(uint8_t channelSelect)
+{
+    HOST_REG16(DMA_BASE + channelSelect + OFS_DMA0CTL) |= DMAEN;
+}
+
+void DMA_enableInterrupt(uint8_t channelSelect)
+{
+    HOST_REG16(DMA_BASE + channelSelect + OFS_DMA0CTL) |= DMAIE;
+}
+
+void DMA_clearInterrupt(uint8_t channelSelect)
+{
+    HOST_REG16(DMA_BASE + channelSelect + OFS_DMA0CTL) &= ~DMAIFG;
+}
+
+/************************************************************
+* CRC
+************************************************************/
+
+// The CRC16 module shifts the bits of a byte written to CRCDI in LSB
+// first, which is CRC-CCITT (0x1021) of the byte with its bits reversed.
+// CRCDIRB takes them MSB first. The result register is kept up to date
+// and CRCRESR holds it bit-reversed, like on the chip.
+static void crcByte(uint16_t baseAddress, uint8_t data, uint8_t lsbFirst)
+{
+    uint16_t crc = HOST_REG16(baseAddress + OFS_CRCINIRES);
+    uint16_t reversed = 0;
+    uint8_t bit;
+    uint8_t in;
+
+    for (bit = 0; bit < 8; bit++)
+    {
+        in = lsbFirst ? (data >> bit) & 1 : (data >> (7 - bit)) & 1;
+        crc = ((crc >> 15) ^ in) ? (crc << 1) ^ 0x1021 : crc << 1;
+    }
+    for (bit = 0; bit < 16; bit++)
+    {
+        reversed |= ((crc >> bit) & 1) << (15 - bit);
+    }
+
+    HOST_REG16(baseAddress + OFS_CRCINIRES) = crc;
+    HOST_REG16(baseAddress + OFS_CRCRESR) = reversed;
+}
+
+void CRC_setSeed(uint16_t baseAddress, uint16_t seed)
+{
+    HOST_REG16(baseAddress + OFS_CRCINIRES) = seed;
+}
+
+void CRC_set8BitData(uint16_t baseAddress, uint8_t dataIn)
+{
+    HOST_REG8(baseAddress + OFS_CRCDI_L) = dataIn;
+    crcByte(baseAddress, dataIn, 1);
+}
+
+// A word goes in from bit 0 to bit 15, which is its low byte then its
+// high byte, each LSB first
+void CRC_set16BitData(uint16_t baseAddress, uint16_t dataIn)
+{
+    HOST_REG16(baseAddress + OFS_CRCDI) = dataIn;
+    crcByte(baseAddress, (uint8_t)dataIn, 1);
+    crcByte(baseAddress, (uint8_t)(dataIn >> 8), 1);
+}
+
+void CRC_set8BitDataReversed(uint16_t baseAddress, uint8_t dataIn)
+{
+    HOST_REG8(baseAddress + OFS_CRCDIRB_L) = dataIn;
+    crcByte(baseAddress, dataIn, 0);
+}
+
+uint16_t CRC_getResult(uint16_t baseAddress)
+{
+    return HOST_REG16(baseAddress + OFS_CRCINIRES);
+}
+
+/************************************************************
+* MPU AND FRAMCTL
+************************************************************/
+
+// Stand-ins for the segment symbols of lnk_msp430fr6989.cmd. Their host
+// addresses only end up in the simulated MPUSEGBx registers.
+uint8_t fram_scores_start;
+uint8_t fram_rx_start;
+
+// Access bits of a segment from an MPU_READ/MPU_WRITE/MPU_EXEC mask
+static uint16_t segmentAccess(uint8_t accmask, uint8_t shift)
+{
+    return (uint16_t)(accmask & (MPU_READ | MPU_WRITE | MPU_EXEC)) << shift;
+}
+
+void MPU_initThreeSegments(uint16_t baseAddress,
+                           MPU_initThreeSegmentsParam *param)
+{
+    uint16_t sam = HOST_REG16(baseAddress + OFS_MPUSAM) & 0xF000;
+
+    sam |= segmentAccess(param->seg1accmask, 0);
+    sam |= segmentAccess(param->seg2accmask, 4);
+    sam |= segmentAccess(param->seg3accmask, 8);
+
+    HOST_REG16(baseAddress + OFS_MPUSEGB1) = param->seg1boundary;
+    HOST_REG16(baseAddress + OFS_MPUSEGB2) = param->seg2boundary;
+    HOST_REG16(baseAddress + OFS_MPUSAM) = sam;
+}
+
+void MPU_start(uint16_t baseAddress)
+{
+    HOST_REG16(baseAddress + OFS_MPUCTL0) |= MPUENA;
+}
+
+// The game only writes the score segment (MPU segment 2) through FRAMCtl,
+// so a write while that segment is read-only is the violation the board
+// would raise. It stops the host program rather than go unnoticed.
+static void checkScoreWrite(void)
+{
+    if ((MPUCTL0 & MPUENA) && !(MPUSAM & MPUSEG2WE))
+    {
+        fprintf(stderr, "MPU: write to the score segment outside its write window\n");
+        abort();
+    }
+}
+
+void FRAMCtl_write16(uint16_t *dataPtr, uint16_t *framPtr,
+                     uint16_t numberOfWords)
+{
+    checkScoreWrite();
+    while (numberOfWords--)
+    {
+        *framPtr++ = *dataPtr++;
+    }
+}
+
+void FRAMCtl_write32(uint32_t *dataPtr, uint32_t *framPtr, uint16_t count)
+{
+    checkScoreWrite();
+    while (count--)
+    {
+        *framPtr++ = *dataPtr++;
+    }
+}
+
+void FRAMCtl_fillMemory32(uint32_t value, uint32_t *framPtr, uint16_t count)
+{
+    checkScoreWrite();
+    while (count--)
+    {
+        *framPtr++ = value;
+    }
+}
+
+/************************************************************
+* eUSCI_A UART
+************************************************************/
+
+uint32_t EUSCI_A_UART_getTransmitBufferAddress(uint16_t baseAddress)
+{
+    return baseAddress + OFS_UCAxTXBUF;
+}
+
+#endif
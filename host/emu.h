@@ -0,0 +1,128 @@
+/******************************************************************************
+ *
+ * FILE: host/emu.h
+ *
+ * PURPOSE:
+ *   Declares the pieces of the MSP430X instruction-set emulator that runs
+ *   the linked firmware (Debug/HH_memorygameproject.out) on Linux.
+ *   - emuCore.c:        MSP430X CPU with CPUXv2 cycle counts
+ *   - emuPeripherals.c: clocks, GPIO, Timer_A/B, eUSCI_A, DMA, MPY32 and LCD_C
+ *   - emuElf.c:         ELF loader, symbol table and per-function profile
+ *   - emuGame.c:        plays the game with the scripted player
+ *   - emuBench.c:       cycles per LCD_showChar call and per KB of UART output
+ *
+ *   Unlike the register model in halHost.c, nothing of the game is
+ *   compiled for the host: the emulator executes the same machine code
+ *   the LaunchPad would, so the cycle counts are the ones the board sees.
+ *
+ * CREATED BY:
+ *   Hanna Szalai & Haroun Riahi
+ *
+ ******************************************************************************/
+
+#ifndef HOST_EMU_H_
+#define HOST_EMU_H_
+
+#include <stdint.h>
+
+// 20-bit address space
+#define EMU_MEMORY_SIZE     0x100000
+#define EMU_ADDRESS_MASK    0xFFFFF
+
+// Peripheral registers live below this address
+#define EMU_PERIPHERAL_END  0x1000
+
+// Status register bits
+#define EMU_SR_C            0x0001
+#define EMU_SR_Z            0x0002
+#define EMU_SR_N            0x0004
+#define EMU_SR_GIE          0x0008
+#define EMU_SR_CPUOFF       0x0010
+#define EMU_SR_OSCOFF       0x0020
+#define EMU_SR_SCG0         0x0040
+#define EMU_SR_SCG1         0x0080
+#define EMU_SR_V            0x0100
+
+// Reset vector
+#define EMU_RESET_VECTOR    0xFFFE
+
+extern uint8_t emuMemory[EMU_MEMORY_SIZE];
+
+/************************************************************
+* CPU (emuCore.c)
+************************************************************/
+
+// Loads PC from the reset vector and clears the registers
+void emuCoreReset(void);
+
+// Runs one instruction, or accepts one interrupt; returns the CPU cycles
+// it took, 0 if the CPU is off
+uint16_t emuCoreStep(void);
+
+uint32_t emuCoreRegister(uint8_t number);
+void     emuCoreSetRegister(uint8_t number, uint32_t value);
+
+// Non-zero when the CPU has stopped itself for good (for example a
+// "while(1);" with interrupts disabled, or an invalid instruction)
+const char *emuCoreHalted(void);
+
+/************************************************************
+* PERIPHERALS (emuPeripherals.c)
+************************************************************/
+
+void     emuPeripheralsReset(void);
+uint16_t emuPeripheralRead(uint32_t address, uint8_t isByte);
+void     emuPeripheralWrite(uint32_t address, uint16_t value, uint8_t isByte);
+
+// Lets the clocks run for a number of MCLK periods; sr tells which clocks
+// the low-power mode has switched off
+void     emuPeripheralsAdvance(uint32_t cycles, uint16_t sr);
+
+// Vector address of the highest-priority pending interrupt, 0 if none
+uint16_t emuPendingInterrupt(void);
+
+// Clears the flag of a single-source interrupt when it is accepted
+void     emuAcknowledgeInterrupt(uint16_t vector);
+
+// MCLK periods to sleep before something could happen in a low-power mode
+uint32_t emuSleepStep(uint16_t sr);
+
+uint32_t emuMclkFrequency(void);
+
+// Simulated time since reset
+uint32_t emuTimeMs(void);
+
+// Button levels (port 1 pins held low) and what the board shows
+void     emuSetButtons(uint8_t held);
+uint8_t  emuLeds(void);
+uint8_t  emuLcdMemory(uint8_t index);
+
+// Simulated time from reset until the LCD first showed a segment, 0 if
+// it has not yet
+uint32_t emuFirstFrameUs(void);
+
+// Called with every byte the UART puts on the wire
+void     emuSetUartOutput(void (*output)(uint8_t byte));
+
+// MCLK cycles the DMA has held the bus since reset
+uint32_t emuDmaCycles(void);
+
+/************************************************************
+* ELF IMAGE AND PROFILE (emuElf.c)
+************************************************************/
+
+// Loads the program segments and the symbol table; returns 0 on success
+int      emuLoadElf(const char *path);
+
+// Address of a symbol, 0 if the image does not have it
+uint32_t emuSymbolAddress(const char *name);
+
+// Profiler hooks called by the CPU
+void     emuProfileInstruction(uint32_t pc, uint16_t cycles);
+void     emuProfileCall(uint32_t target, uint32_t sp);
+void     emuProfileStack(uint32_t sp);
+
+// Prints cycles per function, sorted by inclusive cycles
+void     emuProfileReport(uint64_t totalCycles);
+
+#endif
@@ -0,0 +1,480 @@
+/******************************************************************************
+ *
+ * FILE: host/emuBench.c
+ *
+ * DESCRIPTION:
+ *   Measures what LCD_showChar and UART output cost on the board. It boots
+ *   the linked firmware on the emulator up to main, calls LCD_init, then
+ *   calls LCD_showChar for every character class at every position and
+ *   prints the CPU cycles per call. Run it on the .out files built before
+ *   and after a change to compare them.
+ *
+ *   It then plays every frame of a scrolling message the way the image
+ *   draws it and prints the CPU cycles per frame: with LCD_setFrame from
+ *   cells encoded beforehand if the image has it, otherwise one
+ *   LCD_setCell per position (LCD_showChar on images without the shadow
+ *   framebuffer), each followed by LCD_commit when there is one.
+ *
+ *   Then it times showNumber, and LCD_displayNumber if the image keeps
+ *   it, for a few numbers from one digit to six.
+ *
+ *   If the image has uartPrint and uartSendBlock it then sends one
+ *   kilobyte from FRAM both ways and prints the CPU cycles it took, with
+ *   the interrupts and the bus cycles the DMA took from the CPU.
+ *
+ * BUILD AND RUN (from the repository root):
+ *   gcc -O2 -DHAL_HOST -Ihost -I. host/emuCore.c host/emuPeripherals.c \
+ *       host/emuElf.c host/emuBench.c -o msp430Bench
+ *   ./msp430Bench [firmware.out]
+ *
+ *   The firmware defaults to Debug/HH_memorygameproject.out.
+ *
+ * CREATED BY:
+ *   Hanna Szalai & Haroun Riahi
+ *
+ ******************************************************************************/
+
+#ifdef HAL_HOST
+
+#include <stdio.h>
+#include <string.h>
+#include "emu.h"
+#include "lcdGlyphs.h"
+
+#define DEFAULT_FIRMWARE    "Debug/HH_memorygameproject.out"
+
+// Called functions return here. It is never executed: the call ends as
+// soon as the PC gets there
+#define RETURN_ADDRESS      0x0004
+
+// Give up on a call or on booting after this many cycles
+#define MAX_CYCLES          100000000UL
+
+#define LCD_POSITIONS       6
+
+// Message the scroll benchmark plays
+#define SCROLL_TEXT         "GAME OVER FINAL SCORE"
+
+// Free FRAM the UART benchmark puts its kilobyte and its text in, and the
+// scroll benchmark its encoded message before that
+#define BENCH_DATA          0xA000
+#define BENCH_BYTES         1024
+#define BENCH_TEXT          (BENCH_DATA + BENCH_BYTES)
+#define BENCH_TEXT_LENGTH   64
+
+// eUSCI_A1 and DMA channel 0 registers the benchmark watches
+#define UCA1IE              0x05FA
+#define UCA1IFG             0x05FC
+#define UCTXIE              0x0002
+#define UCTXCPTIFG          0x0008
+#define DMA0CTL             0x0510
+#define DMAEN               0x0010
+
+// Results of uartPrint and uartSendBlock
+#define UART_OK             0
+
+typedef struct
+{
+    const char *name;
+    const char *characters;
+} CharacterClass;
+
+static const CharacterClass classes[] =
+{
+    { "space",  " " },
+    { "digit",  "0123456789" },
+    { "letter", "ABCDEFGHIJKLMNOPQRSTUVWXYZ" },
+    { "other",  "?-*" },
+};
+
+// Runs the CPU until the PC reaches an address; returns the cycles it took,
+// 0 if it did not get there
+static unsigned long runTo(uint32_t address)
+{
+    unsigned long total = 0;
+    uint16_t cycles;
+
+    while (emuCoreRegister(0) != address)
+    {
+        cycles = emuCoreStep();
+        if (!cycles || total > MAX_CYCLES)
+        {
+            return 0;
+        }
+        emuPeripheralsAdvance(cycles, (uint16_t)emuCoreRegister(2));
+        total += cycles;
+    }
+    return total;
+}
+
+// Calls a firmware function with up to three int arguments, with
+// interrupts off. The return address is pushed as a 20-bit word so both
+// RET and RETA come back to it.
+static unsigned long callFunction(uint32_t function, uint16_t first, uint16_t second,
+                                  uint16_t third)
+{
+    uint32_t sp = emuCoreRegister(1);
+    uint32_t sr = emuCoreRegister(2);
+    unsigned long cycles;
+
+    emuCoreSetRegister(1, sp - 4);
+    emuMemory[sp - 4] = (uint8_t)RETURN_ADDRESS;
+    emuMemory[sp - 3] = (uint8_t)(RETURN_ADDRESS >> 8);
+    emuMemory[sp - 2] = 0;
+    emuMemory[sp - 1] = 0;
+    emuCoreSetRegister(2, sr & ~EMU_SR_GIE);
+    emuCoreSetRegister(12, first);
+    emuCoreSetRegister(13, second);
+    emuCoreSetRegister(14, third);
+    emuCoreSetRegister(0, function);
+
+    cycles = runTo(RETURN_ADDRESS);
+
+    emuCoreSetRegister(1, sp);
+    emuCoreSetRegister(2, sr);
+    return cycles;
+}
+
+static const char glyphs[LCD_GLYPH_COUNT][2] =
+{
+    LCD_GLYPH_TABLE
+};
+
+// Character at a position of a scroll frame, blank off the message
+static char scrollCharacter(unsigned int frame, int position)
+{
+    unsigned int index = frame + position;
+
+    if (index < LCD_POSITIONS || index >= LCD_POSITIONS + strlen(SCROLL_TEXT))
+    {
+        return ' ';
+    }
+    return SCROLL_TEXT[index - LCD_POSITIONS];
+}
+
+// Draws every frame of SCROLL_TEXT and prints the cycles per frame
+static int benchScroll(uint32_t showChar, uint32_t setCell, uint32_t setFrame,
+                       uint32_t commit)
+{
+    unsigned int frames = strlen(SCROLL_TEXT) + LCD_POSITIONS;
+    unsigned long total = 0;
+    unsigned long least = ~0UL;
+    unsigned long most = 0;
+    unsigned long cycles;
+    unsigned long call;
+    unsigned int frame;
+    int position;
+    const char *path;
+    char c;
+
+    // LCD_setFrame takes the cells encoded beforehand, as messages.c has them
+    for (frame = 0; frame < frames + LCD_POSITIONS; frame++)
+    {
+        c = scrollCharacter(frame, 0);
+        emuMemory[BENCH_DATA + 2 * frame] = (uint8_t)glyphs[LCD_GLYPH_INDEX((uint8_t)c)][0];
+        emuMemory[BENCH_DATA + 2 * frame + 1] = (uint8_t)glyphs[LCD_GLYPH_INDEX((uint8_t)c)][1];
+    }
+
+    path = setFrame ? "LCD_setFrame" : setCell ? "LCD_setCell" : "LCD_showChar";
+    for (frame = 0; frame < frames; frame++)
+    {
+        cycles = 0;
+        if (setFrame)
+        {
+            cycles = callFunction(setFrame, BENCH_DATA + 2 * frame, 0, 0);
+        }
+        else
+        {
+            for (position = 0; position < LCD_POSITIONS; position++)
+            {
+                call = callFunction(setCell ? setCell : showChar,
+                                    (uint8_t)scrollCharacter(frame, position),
+                                    (uint16_t)(position + 1), 0);
+                if (!call)
+                {
+                    cycles = 0;
+                    break;
+                }
+                cycles += call;
+            }
+        }
+        if (cycles && commit)
+        {
+            call = callFunction(commit, 0, 0, 0);
+            cycles = call ? cycles + call : 0;
+        }
+        if (!cycles)
+        {
+            fprintf(stderr, "%s frame %u did not return\n", path, frame);
+            return 2;
+        }
+        total += cycles;
+        least = cycles < least ? cycles : least;
+        most = cycles > most ? cycles : most;
+    }
+
+    memset(&emuMemory[BENCH_DATA], 0, 2 * (frames + LCD_POSITIONS));
+
+    printf("\nScrolling \"%s\"\n", SCROLL_TEXT);
+    printf("path            frames  cycles/frame    min    max\n");
+    printf("%-14s %7u %13.1f %6lu %6lu\n", path, frames, (double)total / frames, least, most);
+    return 0;
+}
+
+// Times a function taking one unsigned long for every number of numbers[]
+static int benchNumber(const char *name, uint32_t function)
+{
+    static const uint32_t numbers[] = { 0, 16, 99999, 999999 };
+    unsigned long cycles;
+    unsigned int i;
+
+    printf("%-17s", name);
+    for (i = 0; i < sizeof(numbers) / sizeof(numbers[0]); i++)
+    {
+        // An unsigned long is passed in R12 (low word) and R13
+        cycles = callFunction(function, (uint16_t)numbers[i], (uint16_t)(numbers[i] >> 16), 0);
+        if (!cycles)
+        {
+            fprintf(stderr, "\n%s(%lu) did not return\n", name, (unsigned long)numbers[i]);
+            return 2;
+        }
+        printf(" %9lu", cycles);
+    }
+    printf("\n");
+    return 0;
+}
+
+static uint16_t readRegister(uint16_t address)
+{
+    return emuMemory[address] | (emuMemory[address + 1] << 8);
+}
+
+// Nothing queued, no DMA running and the last frame has left the wire
+static int uartIdle(void)
+{
+    return !(readRegister(UCA1IE) & UCTXIE) && !(readRegister(DMA0CTL) & DMAEN)
+           && (readRegister(UCA1IFG) & UCTXCPTIFG);
+}
+
+// Sleeps in LPM0 with interrupts on until the UART is idle; returns the
+// CPU cycles the ISRs took meanwhile. An ISR that wakes the CPU comes back
+// to the return address, where the CPU goes straight back to sleep.
+static unsigned long sleepUntilUartIdle(void)
+{
+    uint32_t sr = emuCoreRegister(2);
+    uint32_t sleepSR = EMU_SR_GIE | EMU_SR_CPUOFF;
+    unsigned long busy = 0;
+    unsigned long total = 0;
+    uint16_t cycles;
+
+    emuCoreSetRegister(0, RETURN_ADDRESS);
+    emuCoreSetRegister(2, sleepSR);
+    while (!uartIdle() && total < MAX_CYCLES)
+    {
+        if (emuCoreRegister(0) == RETURN_ADDRESS)
+        {
+            emuCoreSetRegister(2, sleepSR);
+        }
+        cycles = emuCoreStep();
+        if (cycles)
+        {
+            busy += cycles;
+        }
+        else
+        {
+            cycles = (uint16_t)emuSleepStep(sleepSR);
+        }
+        emuPeripheralsAdvance(cycles, (uint16_t)emuCoreRegister(2));
+        total += cycles;
+    }
+
+    emuCoreSetRegister(2, sr);
+    return busy;
+}
+
+static void printUartResult(const char *name, unsigned long calls,
+                            unsigned long callCycles, unsigned long isrCycles,
+                            uint32_t dmaCycles, uint32_t ms)
+{
+    printf("%-14s %5lu %11lu %11lu %9lu %11lu %6lu\n", name, calls, callCycles,
+           isrCycles, (unsigned long)dmaCycles,
+           callCycles + isrCycles + dmaCycles, (unsigned long)ms);
+}
+
+// Sends BENCH_BYTES with uartPrint through the ring buffer, then with
+// uartSendBlock by DMA
+static int benchUart(uint32_t uartInit, uint32_t print, uint32_t sendBlock)
+{
+    unsigned long calls = 0;
+    unsigned long callCycles = 0;
+    unsigned long isrCycles = 0;
+    unsigned long sent = 0;
+    uint32_t dmaCycles;
+    uint32_t started;
+    unsigned int i;
+
+    for (i = 0; i < BENCH_BYTES + BENCH_TEXT_LENGTH + 1; i++)
+    {
+        if (emuMemory[BENCH_DATA + i])
+        {
+            fprintf(stderr, "FRAM at 0x%04X is used by the image, no room for the UART benchmark\n",
+                    BENCH_DATA);
+            return 2;
+        }
+    }
+    for (i = 0; i < BENCH_BYTES; i++)
+    {
+        emuMemory[BENCH_DATA + i] = 'A' + i % 26;
+    }
+    for (i = 0; i < BENCH_TEXT_LENGTH; i++)
+    {
+        emuMemory[BENCH_TEXT + i] = 'A' + i % 26;
+    }
+
+    if (!callFunction(uartInit, 0, 0, 0))
+    {
+        fprintf(stderr, "uart_init did not return\n");
+        return 2;
+    }
+    sleepUntilUartIdle();
+
+    printf("\n%d bytes         calls  call cycles  ISR cycles  DMA bus  total cycles     ms\n",
+           BENCH_BYTES);
+
+    // A full ring drops the text, so wait for it to drain and try again
+    started = emuTimeMs();
+    while (sent < BENCH_BYTES)
+    {
+        callCycles += callFunction(print, BENCH_TEXT, 0, 0);
+        calls++;
+        if (emuCoreRegister(12) == UART_OK)
+        {
+            sent += BENCH_TEXT_LENGTH;
+        }
+        else
+        {
+            isrCycles += sleepUntilUartIdle();
+        }
+    }
+    isrCycles += sleepUntilUartIdle();
+    printUartResult("uartPrint", calls, callCycles, isrCycles, 0, emuTimeMs() - started);
+
+    started = emuTimeMs();
+    dmaCycles = emuDmaCycles();
+    callCycles = callFunction(sendBlock, BENCH_DATA, BENCH_BYTES, 0);
+    if (emuCoreRegister(12) != UART_OK)
+    {
+        fprintf(stderr, "uartSendBlock refused the block\n");
+        return 2;
+    }
+    isrCycles = sleepUntilUartIdle();
+    printUartResult("uartSendBlock", 1, callCycles, isrCycles, emuDmaCycles() - dmaCycles,
+                    emuTimeMs() - started);
+
+    return 0;
+}
+
+int main(int argc, char *argv[])
+{
+    const char *firmware = argc > 1 ? argv[1] : DEFAULT_FIRMWARE;
+    uint32_t mainAddress;
+    uint32_t lcdInit;
+    uint32_t showChar;
+    uint32_t uartInit;
+    uint32_t print;
+    uint32_t sendBlock;
+    unsigned long cycles;
+    unsigned long classCycles;
+    unsigned long allCycles = 0;
+    unsigned long allCalls = 0;
+    unsigned long calls;
+    unsigned long least;
+    unsigned long most;
+    unsigned int i;
+    int position;
+    const char *c;
+
+    if (emuLoadElf(firmware) != 0)
+    {
+        return 2;
+    }
+    mainAddress = emuSymbolAddress("main");
+    lcdInit = emuSymbolAddress("LCD_init");
+    showChar = emuSymbolAddress("LCD_showChar");
+    if (!mainAddress || !lcdInit || !showChar)
+    {
+        fprintf(stderr, "%s: no main, LCD_init or LCD_showChar\n", firmware);
+        return 2;
+    }
+
+    emuPeripheralsReset();
+    emuCoreReset();
+    if (!runTo(mainAddress) || !callFunction(lcdInit, 0, 0, 0))
+    {
+        fprintf(stderr, "%s: did not get through the start-up code\n", firmware);
+        return 2;
+    }
+
+    printf("firmware: %s\n\n", firmware);
+    printf("LCD_showChar   calls   cycles/call    min    max\n");
+    for (i = 0; i < sizeof(classes) / sizeof(classes[0]); i++)
+    {
+        classCycles = 0;
+        calls = 0;
+        least = ~0UL;
+        most = 0;
+        for (c = classes[i].characters; *c; c++)
+        {
+            for (position = 1; position <= LCD_POSITIONS; position++)
+            {
+                cycles = callFunction(showChar, (uint8_t)*c, (uint16_t)position, 0);
+                if (!cycles)
+                {
+                    fprintf(stderr, "LCD_showChar('%c', %d) did not return\n", *c, position);
+                    return 2;
+                }
+                classCycles += cycles;
+                calls++;
+                least = cycles < least ? cycles : least;
+                most = cycles > most ? cycles : most;
+            }
+        }
+        printf("%-10s %9lu %13.1f %6lu %6lu\n", classes[i].name, calls,
+               (double)classCycles / calls, least, most);
+        allCycles += classCycles;
+        allCalls += calls;
+    }
+    printf("%-10s %9lu %13.1f\n", "all", allCalls, (double)allCycles / allCalls);
+    printf("\nA full six-character screen costs about %lu cycles\n",
+           allCycles * LCD_POSITIONS / allCalls);
+
+    if (benchScroll(showChar, emuSymbolAddress("LCD_setCell"), emuSymbolAddress("LCD_setFrame"),
+                    emuSymbolAddress("LCD_commit")) != 0)
+    {
+        return 2;
+    }
+
+    printf("\nNumber cycles             0        16     99999    999999\n");
+    if (emuSymbolAddress("showNumber") && benchNumber("showNumber", emuSymbolAddress("showNumber")) != 0)
+    {
+        return 2;
+    }
+    if (emuSymbolAddress("LCD_displayNumber")
+        && benchNumber("LCD_displayNumber", emuSymbolAddress("LCD_displayNumber")) != 0)
+    {
+        return 2;
+    }
+
+    uartInit = emuSymbolAddress("uart_init");
+    print = emuSymbolAddress("uartPrint");
+    sendBlock = emuSymbolAddress("uartSendBlock");
+    if (!uartInit || !print || !sendBlock)
+    {
+        printf("\nNo uart_init, uartPrint or uartSendBlock: UART benchmark skipped\n");
+        return 0;
+    }
+
+    return benchUart(uartInit, print, sendBlock);
+}
+
+#endif
@@ -0,0 +1,1065 @@
+/******************************************************************************
+ *
+ * FILE: host/emuCore.c
+ *
+ * DESCRIPTION:
+ *   MSP430X CPU of the instruction-set emulator. Executes the full
+ *   MSP430X instruction set the TI compiler emits for the FR6989:
+ *   - Format I and II instructions, with and without extension words
+ *     (.B, .W and 20-bit .A operands, RPT and ZC in register mode)
+ *   - jumps, CALLA/RETA, MOVA/ADDA/SUBA/CMPA, PUSHM/POPM, RRxM
+ *   - interrupt entry and RETI with the 20-bit PC folded into the SR word
+ *
+ *   Cycle counts come from the CPUXv2 instruction timing tables of the
+ *   MSP430FR58xx/59xx/68xx/69xx family user's guide. The game runs at
+ *   4 MHz, below the 8 MHz where FRAM starts to need wait states, so no
+ *   wait states are added.
+ *
+ * CREATED BY:
+ *   Hanna Szalai & Haroun Riahi
+ *
+ ******************************************************************************/
+
+#ifdef HAL_HOST
+
+#include <stdio.h>
+#include "emu.h"
+
+#define PC      reg[0]
+#define SP      reg[1]
+#define SR      reg[2]
+
+// Operand sizes
+#define SIZE_BYTE       0
+#define SIZE_WORD       1
+#define SIZE_ADDRESS    2
+
+// Where an operand lives
+#define OPERAND_REGISTER    0
+#define OPERAND_MEMORY      1
+#define OPERAND_CONSTANT    2
+
+// Source addressing classes of the cycle tables
+#define CLASS_REGISTER      0   // Rn and constant-generator values
+#define CLASS_INDIRECT      1   // @Rn
+#define CLASS_INCREMENT     2   // @Rn+
+#define CLASS_IMMEDIATE     3   // #N
+#define CLASS_INDEXED       4   // X(Rn), EDE and &EDE
+
+// Destination classes of the cycle tables
+#define TARGET_REGISTER     0
+#define TARGET_PC           1
+#define TARGET_MEMORY       2
+
+// Format I opcodes
+#define OP_MOV      0x4
+#define OP_ADD      0x5
+#define OP_ADDC     0x6
+#define OP_SUBC     0x7
+#define OP_SUB      0x8
+#define OP_CMP      0x9
+#define OP_DADD     0xA
+#define OP_BIT      0xB
+#define OP_BIC      0xC
+#define OP_BIS      0xD
+#define OP_XOR      0xE
+#define OP_AND      0xF
+
+// Format II opcodes
+#define OP_RRC      0
+#define OP_SWPB     1
+#define OP_RRA      2
+#define OP_SXT      3
+#define OP_PUSH     4
+#define OP_CALL     5
+
+// Cycles of interrupt entry and RETI
+#define INTERRUPT_CYCLES    6
+#define RETI_CYCLES         5
+
+// Format I cycles by source class and destination class
+static const uint8_t formatOneCycles[5][3] =
+{
+    { 1, 3, 4 },    // Rn
+    { 2, 4, 5 },    // @Rn
+    { 2, 4, 5 },    // @Rn+
+    { 2, 3, 5 },    // #N
+    { 3, 5, 6 }     // X(Rn), EDE, &EDE
+};
+
+// Format II cycles by operand class for RRA/RRC/SWPB/SXT, PUSH and CALL
+static const uint8_t formatTwoCycles[5][3] =
+{
+    { 1, 3, 4 },    // Rn
+    { 3, 3, 4 },    // @Rn
+    { 3, 3, 4 },    // @Rn+
+    { 3, 3, 4 },    // #N
+    { 4, 4, 5 }     // X(Rn), EDE, &EDE
+};
+
+static const uint32_t sizeMask[3] = { 0xFF, 0xFFFF, 0xFFFFF };
+static const uint32_t sizeSign[3] = { 0x80, 0x8000, 0x80000 };
+
+typedef struct
+{
+    uint8_t  kind;
+    uint8_t  reg;
+    uint32_t value;     // Address of a memory operand, value of a constant
+} Operand;
+
+uint8_t emuMemory[EMU_MEMORY_SIZE];
+
+static uint32_t reg[16];
+static const char *haltReason = 0;
+static uint8_t callPending = 0;     // The last instruction was a call
+static char haltMessage[80];
+
+/************************************************************
+* MEMORY
+************************************************************/
+
+static uint16_t readWord(uint32_t address)
+{
+    address &= EMU_ADDRESS_MASK & ~1UL;
+    if (address < EMU_PERIPHERAL_END)
+    {
+        return emuPeripheralRead(address, 0);
+    }
+    return emuMemory[address] | (emuMemory[address + 1] << 8);
+}
+
+static uint8_t readByte(uint32_t address)
+{
+    address &= EMU_ADDRESS_MASK;
+    if (address < EMU_PERIPHERAL_END)
+    {
+        return (uint8_t)emuPeripheralRead(address, 1);
+    }
+    return emuMemory[address];
+}
+
+static void writeWord(uint32_t address, uint16_t value)
+{
+    address &= EMU_ADDRESS_MASK & ~1UL;
+    if (address < EMU_PERIPHERAL_END)
+    {
+        emuPeripheralWrite(address, value, 0);
+        return;
+    }
+    emuMemory[address] = (uint8_t)value;
+    emuMemory[address + 1] = (uint8_t)(value >> 8);
+}
+
+static void writeByte(uint32_t address, uint8_t value)
+{
+    address &= EMU_ADDRESS_MASK;
+    if (address < EMU_PERIPHERAL_END)
+    {
+        emuPeripheralWrite(address, value, 1);
+        return;
+    }
+    emuMemory[address] = value;
+}
+
+// 20-bit values take two words in memory, low word first
+static uint32_t readAddress(uint32_t address)
+{
+    return readWord(address) | ((uint32_t)(readWord(address + 2) & 0x000F) << 16);
+}
+
+static void writeAddress(uint32_t address, uint32_t value)
+{
+    writeWord(address, (uint16_t)value);
+    writeWord(address + 2, (uint16_t)((value >> 16) & 0x000F));
+}
+
+static uint16_t fetch(void)
+{
+    uint16_t word = readWord(PC);
+
+    PC = (PC + 2) & EMU_ADDRESS_MASK;
+    return word;
+}
+
+static uint32_t signExtend16(uint16_t value)
+{
+    return (uint32_t)(int32_t)(int16_t)value;
+}
+
+static void halt(const char *reason, uint32_t address)
+{
+    snprintf(haltMessage, sizeof(haltMessage), "%s at 0x%05lX",
+             reason, (unsigned long)address);
+    haltReason = haltMessage;
+}
+
+/************************************************************
+* REGISTERS AND OPERANDS
+************************************************************/
+
+static void setRegister(uint8_t number, uint32_t value, uint8_t size)
+{
+    value &= sizeMask[size];
+
+    switch (number)
+    {
+    case 0:
+        PC = value & ~1UL;
+        break;
+    case 2:
+        SR = value & 0xFFFF;
+        break;
+    case 3:
+        // Constant generator, writes go nowhere
+        break;
+    default:
+        reg[number] = value;
+        break;
+    }
+}
+
+// Address of X(Rn) or EDE. Without an extension word, a base in the lower
+// 64 KB wraps at 16 bits, as on the real CPU.
+static uint32_t indexedAddress(uint32_t base, uint16_t index, uint8_t extended,
+                               uint8_t high)
+{
+    if (extended)
+    {
+        return (base + (((uint32_t)high << 16) | index)) & EMU_ADDRESS_MASK;
+    }
+    if (base < 0x10000)
+    {
+        return (base + index) & 0xFFFF;
+    }
+    return (base + signExtend16(index)) & EMU_ADDRESS_MASK;
+}
+
+// Decodes a source operand (or the single operand of Format II); returns
+// its class for the cycle tables
+static uint8_t sourceOperand(uint8_t rs, uint8_t as, uint8_t size,
+                             uint8_t extended, uint8_t high, Operand *operand)
+{
+    uint32_t base;
+    uint16_t index;
+
+    operand->kind = OPERAND_MEMORY;
+    operand->reg = rs;
+
+    // Constant generators
+    if (rs == 3)
+    {
+        static const uint32_t constants[4] = { 0, 1, 2, 0xFFFFF };
+
+        operand->kind = OPERAND_CONSTANT;
+        operand->value = constants[as];
+        return CLASS_REGISTER;
+    }
+    if (rs == 2 && as >= 2)
+    {
+        operand->kind = OPERAND_CONSTANT;
+        operand->value = (as == 2) ? 4 : 8;
+        return CLASS_REGISTER;
+    }
+
+    switch (as)
+    {
+    case 0:
+        operand->kind = OPERAND_REGISTER;
+        return CLASS_REGISTER;
+
+    case 1:
+        base = PC;
+        index = fetch();
+        if (rs == 2)
+        {
+            operand->value = extended ? (((uint32_t)high << 16) | index) : index;
+        }
+        else
+        {
+            operand->value = indexedAddress(rs == 0 ? base : reg[rs], index,
+                                            extended, high);
+        }
+        return CLASS_INDEXED;
+
+    case 2:
+        operand->value = reg[rs];
+        return CLASS_INDIRECT;
+
+    default:
+        if (rs == 0)
+        {
+            index = fetch();
+            operand->kind = OPERAND_CONSTANT;
+            operand->value = extended ? (((uint32_t)high << 16) | index) : index;
+            return CLASS_IMMEDIATE;
+        }
+        operand->value = reg[rs];
+        if (size == SIZE_ADDRESS)
+        {
+            reg[rs] = (reg[rs] + 4) & EMU_ADDRESS_MASK;
+        }
+        else if (size == SIZE_WORD || rs == 1)
+        {
+            reg[rs] = (reg[rs] + 2) & EMU_ADDRESS_MASK;
+        }
+        else
+        {
+            reg[rs] = (reg[rs] + 1) & EMU_ADDRESS_MASK;
+        }
+        return CLASS_INCREMENT;
+    }
+}
+
+// Decodes a Format I destination operand; returns its class
+static uint8_t destinationOperand(uint8_t rd, uint8_t ad, uint8_t extended,
+                                  uint8_t high, Operand *operand)
+{
+    uint32_t base;
+    uint16_t index;
+
+    operand->reg = rd;
+    if (ad == 0)
+    {
+        operand->kind = OPERAND_REGISTER;
+        return rd == 0 ? TARGET_PC : TARGET_REGISTER;
+    }
+
+    operand->kind = OPERAND_MEMORY;
+    base = PC;
+    index = fetch();
+    if (rd == 2)
+    {
+        operand->value = extended ? (((uint32_t)high << 16) | index) : index;
+    }
+    else
+    {
+        operand->value = indexedAddress(rd == 0 ? base : reg[rd], index,
+                                        extended, high);
+    }
+    return TARGET_MEMORY;
+}
+
+static uint32_t readOperand(const Operand *operand, uint8_t size)
+{
+    switch (operand->kind)
+    {
+    case OPERAND_REGISTER:
+        return reg[operand->reg] & sizeMask[size];
+    case OPERAND_CONSTANT:
+        return operand->value & sizeMask[size];
+    default:
+        if (size == SIZE_BYTE)
+        {
+            return readByte(operand->value);
+        }
+        if (size == SIZE_WORD)
+        {
+            return readWord(operand->value);
+        }
+        return readAddress(operand->value);
+    }
+}
+
+static void writeOperand(const Operand *operand, uint8_t size, uint32_t value)
+{
+    if (operand->kind == OPERAND_REGISTER)
+    {
+        setRegister(operand->reg, value, size);
+    }
+    else if (operand->kind == OPERAND_MEMORY)
+    {
+        if (size == SIZE_BYTE)
+        {
+            writeByte(operand->value, (uint8_t)value);
+        }
+        else if (size == SIZE_WORD)
+        {
+            writeWord(operand->value, (uint16_t)value);
+        }
+        else
+        {
+            writeAddress(operand->value, value);
+        }
+    }
+}
+
+/************************************************************
+* FLAGS
+************************************************************/
+
+static void setFlags(uint32_t result, uint8_t size, uint8_t carry, uint8_t overflow)
+{
+    uint16_t flags = 0;
+
+    if ((result & sizeMask[size]) == 0)
+    {
+        flags |= EMU_SR_Z;
+    }
+    if (result & sizeSign[size])
+    {
+        flags |= EMU_SR_N;
+    }
+    if (carry)
+    {
+        flags |= EMU_SR_C;
+    }
+    if (overflow)
+    {
+        flags |= EMU_SR_V;
+    }
+    SR = (SR & ~(EMU_SR_C | EMU_SR_Z | EMU_SR_N | EMU_SR_V)) | flags;
+}
+
+// a + b + carry with the flags of ADD, ADDC, SUB, SUBC and CMP
+static uint32_t addWithFlags(uint32_t a, uint32_t b, uint32_t carry, uint8_t size)
+{
+    uint32_t result = a + b + carry;
+    uint32_t sign = sizeSign[size];
+
+    setFlags(result, size, result > sizeMask[size],
+             ((~(a ^ b) & (a ^ result)) & sign) != 0);
+    return result & sizeMask[size];
+}
+
+static uint32_t decimalAdd(uint32_t a, uint32_t b, uint32_t carry, uint8_t size)
+{
+    static const uint8_t nibbles[3] = { 2, 4, 5 };
+    uint32_t result = 0;
+    uint32_t digit;
+    uint8_t i;
+
+    for (i = 0; i < nibbles[size]; i++)
+    {
+        digit = ((a >> (4 * i)) & 0xF) + ((b >> (4 * i)) & 0xF) + carry;
+        carry = digit > 9;
+        if (carry)
+        {
+            digit -= 10;
+        }
+        result |= (digit & 0xF) << (4 * i);
+    }
+
+    setFlags(result, size, carry != 0, 0);
+    return result;
+}
+
+/************************************************************
+* INSTRUCTIONS
+************************************************************/
+
+static void executeFormatOne(uint8_t opcode, const Operand *src, const Operand *dst,
+                             uint8_t size, uint8_t zeroCarry)
+{
+    uint32_t mask = sizeMask[size];
+    uint32_t carry = zeroCarry ? 0 : (SR & EMU_SR_C);
+    uint32_t s = readOperand(src, size);
+    uint32_t d = 0;
+    uint32_t result;
+
+    if (opcode != OP_MOV)
+    {
+        d = readOperand(dst, size);
+    }
+
+    switch (opcode)
+    {
+    case OP_MOV:  result = s;                                          break;
+    case OP_ADD:  result = addWithFlags(d, s, 0, size);                break;
+    case OP_ADDC: result = addWithFlags(d, s, carry, size);            break;
+    case OP_SUBC: result = addWithFlags(d, ~s & mask, carry, size);    break;
+    case OP_SUB:  result = addWithFlags(d, ~s & mask, 1, size);        break;
+    case OP_CMP:  addWithFlags(d, ~s & mask, 1, size);                 return;
+    case OP_DADD: result = decimalAdd(d, s, carry, size);              break;
+    case OP_BIT:
+        result = d & s;
+        setFlags(result, size, result != 0, 0);
+        return;
+    case OP_BIC:  result = d & ~s;                                     break;
+    case OP_BIS:  result = d | s;                                      break;
+    case OP_XOR:
+        result = d ^ s;
+        setFlags(result, size, (result & mask) != 0,
+                 (s & sizeSign[size]) && (d & sizeSign[size]));
+        break;
+    default:
+        result = d & s;
+        setFlags(result, size, (result & mask) != 0, 0);
+        break;
+    }
+
+    writeOperand(dst, size, result);
+}
+
+// Operand size from the B/W bit and, when there is one, the A/L bit of the
+// extension word
+static uint8_t operandSize(uint16_t op, uint8_t extended, uint16_t extension)
+{
+    uint8_t byteMode = (op >> 6) & 1;
+
+    if (extended && !((extension >> 6) & 1))
+    {
+        return byteMode ? SIZE_ADDRESS : SIZE_WORD;
+    }
+    return byteMode ? SIZE_BYTE : SIZE_WORD;
+}
+
+// Repeat count of an extended register-mode instruction (RPT)
+static uint8_t repeatCount(uint16_t extension)
+{
+    if (extension & 0x0080)
+    {
+        return (reg[extension & 0xF] & 0xF) + 1;
+    }
+    return (extension & 0xF) + 1;
+}
+
+static uint16_t formatOne(uint16_t op, uint8_t extended, uint16_t extension)
+{
+    uint8_t opcode = op >> 12;
+    uint8_t rs = (op >> 8) & 0xF;
+    uint8_t ad = (op >> 7) & 1;
+    uint8_t as = (op >> 4) & 3;
+    uint8_t rd = op & 0xF;
+    uint8_t size = operandSize(op, extended, extension);
+    uint8_t registerMode = (as == 0 && ad == 0);
+    uint8_t useExtension = extended && !registerMode;
+    uint8_t repeat = 1;
+    uint8_t zeroCarry = 0;
+    uint8_t sourceClass;
+    uint8_t targetClass;
+    uint16_t cycles;
+    Operand src;
+    Operand dst;
+    uint8_t i;
+
+    if (extended && registerMode)
+    {
+        repeat = repeatCount(extension);
+        zeroCarry = (extension >> 8) & 1;
+    }
+
+    sourceClass = sourceOperand(rs, as, size, useExtension, (extension >> 7) & 0xF, &src);
+    targetClass = destinationOperand(rd, ad, useExtension, extension & 0xF, &dst);
+
+    cycles = formatOneCycles[sourceClass][targetClass];
+    if (targetClass == TARGET_MEMORY &&
+        (opcode == OP_MOV || opcode == OP_BIT || opcode == OP_CMP))
+    {
+        cycles--;
+    }
+    if (extended)
+    {
+        cycles += repeat;
+    }
+
+    for (i = 0; i < repeat; i++)
+    {
+        executeFormatOne(opcode, &src, &dst, size, zeroCarry);
+    }
+
+    return cycles;
+}
+
+static void executeFormatTwo(uint8_t opcode, const Operand *operand, uint8_t size,
+                             uint8_t zeroCarry)
+{
+    uint32_t sign = sizeSign[size];
+    uint32_t value = readOperand(operand, size);
+    uint32_t carryIn = zeroCarry ? 0 : (SR & EMU_SR_C);
+    uint32_t result;
+
+    switch (opcode)
+    {
+    case OP_RRC:
+        result = (value >> 1) | (carryIn ? sign : 0);
+        setFlags(result, size, value & 1, 0);
+        break;
+
+    case OP_SWPB:
+        result = ((value & 0x00FF) << 8) | ((value >> 8) & 0x00FF);
+        if (size == SIZE_ADDRESS)
+        {
+            result |= value & 0xF0000;
+        }
+        break;
+
+    case OP_RRA:
+        result = (value >> 1) | (value & sign);
+        setFlags(result, size, value & 1, 0);
+        break;
+
+    case OP_SXT:
+        // In register mode bit 7 is extended all the way to bit 19
+        if (operand->kind == OPERAND_REGISTER)
+        {
+            size = SIZE_ADDRESS;
+        }
+        result = (value & 0x80) ? (value | 0xFFF00) : (value & 0xFF);
+        result &= sizeMask[size];
+        setFlags(result, size, (result & sizeMask[size]) != 0, 0);
+        break;
+
+    default:
+        // PUSH
+        if (size == SIZE_ADDRESS)
+        {
+            SP = (SP - 4) & EMU_ADDRESS_MASK;
+            writeAddress(SP, value);
+        }
+        else
+        {
+            SP = (SP - 2) & EMU_ADDRESS_MASK;
+            if (size == SIZE_BYTE)
+            {
+                writeByte(SP, (uint8_t)value);
+            }
+            else
+            {
+                writeWord(SP, (uint16_t)value);
+            }
+        }
+        return;
+    }
+
+    writeOperand(operand, size, result);
+}
+
+static uint16_t formatTwo(uint16_t op, uint8_t extended, uint16_t extension)
+{
+    uint8_t opcode = (op >> 7) & 7;
+    uint8_t as = (op >> 4) & 3;
+    uint8_t rd = op & 0xF;
+    uint8_t size = operandSize(op, extended, extension);
+    uint8_t registerMode = (as == 0);
+    uint8_t repeat = 1;
+    uint8_t zeroCarry = 0;
+    uint8_t operandClass;
+    uint8_t column;
+    uint16_t cycles;
+    uint32_t target;
+    Operand operand;
+    uint8_t i;
+
+    if (extended && registerMode)
+    {
+        repeat = repeatCount(extension);
+        zeroCarry = (extension >> 8) & 1;
+    }
+
+    operandClass = sourceOperand(rd, as, size, extended && !registerMode,
+                                 extension & 0xF, &operand);
+    column = (opcode == OP_PUSH) ? 1 : (opcode == OP_CALL) ? 2 : 0;
+    cycles = formatTwoCycles[operandClass][column];
+    if (extended)
+    {
+        cycles += repeat;
+    }
+
+    if (opcode == OP_CALL)
+    {
+        target = readOperand(&operand, SIZE_WORD);
+        SP = (SP - 2) & EMU_ADDRESS_MASK;
+        writeWord(SP, (uint16_t)PC);
+        PC = target & 0xFFFE;
+        callPending = 1;
+        return cycles;
+    }
+
+    for (i = 0; i < repeat; i++)
+    {
+        executeFormatTwo(opcode, &operand, size, zeroCarry);
+    }
+    return cycles;
+}
+
+static uint16_t jump(uint16_t op, uint32_t address)
+{
+    uint32_t offset = op & 0x03FF;
+    uint8_t taken;
+    uint8_t n = (SR & EMU_SR_N) != 0;
+    uint8_t v = (SR & EMU_SR_V) != 0;
+
+    switch ((op >> 10) & 7)
+    {
+    case 0:  taken = !(SR & EMU_SR_Z); break;   // JNE
+    case 1:  taken = (SR & EMU_SR_Z) != 0; break; // JEQ
+    case 2:  taken = !(SR & EMU_SR_C); break;   // JNC
+    case 3:  taken = (SR & EMU_SR_C) != 0; break; // JC
+    case 4:  taken = n; break;                  // JN
+    case 5:  taken = (n == v); break;           // JGE
+    case 6:  taken = (n != v); break;           // JL
+    default: taken = 1; break;                  // JMP
+    }
+
+    // A jump to itself with interrupts off can never end
+    if (op == 0x3FFF && !(SR & EMU_SR_GIE))
+    {
+        halt("endless loop with interrupts disabled", address);
+    }
+
+    if (taken)
+    {
+        if (offset & 0x0200)
+        {
+            offset |= ~0x03FFUL;
+        }
+        PC = (PC + 2 * offset) & EMU_ADDRESS_MASK;
+    }
+    return 2;
+}
+
+static uint32_t rotate(uint8_t kind, uint32_t value, uint8_t size, uint8_t count)
+{
+    uint32_t sign = sizeSign[size];
+    uint8_t carry = (SR & EMU_SR_C) != 0;
+    uint8_t i;
+
+    for (i = 0; i < count; i++)
+    {
+        switch (kind)
+        {
+        case 0:     // RRCM
+            {
+                uint8_t out = value & 1;
+                value = (value >> 1) | (carry ? sign : 0);
+                carry = out;
+            }
+            break;
+        case 1:     // RRAM
+            carry = value & 1;
+            value = (value >> 1) | (value & sign);
+            break;
+        case 2:     // RLAM
+            carry = (value & sign) != 0;
+            value = (value << 1) & sizeMask[size];
+            break;
+        default:    // RRUM
+            carry = value & 1;
+            value >>= 1;
+            break;
+        }
+    }
+
+    setFlags(value, size, carry, 0);
+    return value & sizeMask[size];
+}
+
+// MOVA, CMPA, ADDA, SUBA and RRxM (opcodes 0x0000-0x0FFF)
+static uint16_t addressInstruction(uint16_t op)
+{
+    uint8_t src = (op >> 8) & 0xF;
+    uint8_t dst = op & 0xF;
+    uint8_t toPC = (dst == 0);
+    uint32_t value;
+    uint16_t word;
+
+    switch ((op >> 4) & 0xF)
+    {
+    case 0x0:   // MOVA @Rsrc,Rdst
+        setRegister(dst, readAddress(reg[src]), SIZE_ADDRESS);
+        return toPC ? 4 : 3;
+
+    case 0x1:   // MOVA @Rsrc+,Rdst (RETA is MOVA @SP+,PC)
+        value = readAddress(reg[src]);
+        reg[src] = (reg[src] + 4) & EMU_ADDRESS_MASK;
+        setRegister(dst, value, SIZE_ADDRESS);
+        return toPC ? 4 : 3;
+
+    case 0x2:   // MOVA &abs20,Rdst
+        word = fetch();
+        setRegister(dst, readAddress(((uint32_t)src << 16) | word), SIZE_ADDRESS);
+        return toPC ? 5 : 4;
+
+    case 0x3:   // MOVA X(Rsrc),Rdst
+        word = fetch();
+        setRegister(dst, readAddress(reg[src] + signExtend16(word)), SIZE_ADDRESS);
+        return toPC ? 5 : 4;
+
+    case 0x4:   // RRCM.A, RRAM.A, RLAM.A, RRUM.A
+    case 0x5:   // .W forms
+        {
+            uint8_t size = (op & 0x0010) ? SIZE_WORD : SIZE_ADDRESS;
+            uint8_t count = ((op >> 10) & 3) + 1;
+
+            setRegister(dst, rotate((op >> 8) & 3, reg[dst] & sizeMask[size], size, count), size);
+            return count;
+        }
+
+    case 0x6:   // MOVA Rsrc,&abs20
+        word = fetch();
+        writeAddress(((uint32_t)dst << 16) | word, reg[src]);
+        return 4;
+
+    case 0x7:   // MOVA Rsrc,X(Rdst)
+        word = fetch();
+        writeAddress(reg[dst] + signExtend16(word), reg[src]);
+        return 4;
+
+    case 0x8:   // MOVA #imm20,Rdst
+        word = fetch();
+        setRegister(dst, ((uint32_t)src << 16) | word, SIZE_ADDRESS);
+        return toPC ? 3 : 2;
+
+    case 0x9:   // CMPA #imm20,Rdst
+        word = fetch();
+        addWithFlags(reg[dst], ~(((uint32_t)src << 16) | word) & 0xFFFFF, 1, SIZE_ADDRESS);
+        return 3;
+
+    case 0xA:   // ADDA #imm20,Rdst
+        word = fetch();
+        setRegister(dst, addWithFlags(reg[dst], ((uint32_t)src << 16) | word, 0, SIZE_ADDRESS), SIZE_ADDRESS);
+        return 3;
+
+    case 0xB:   // SUBA #imm20,Rdst
+        word = fetch();
+        setRegister(dst, addWithFlags(reg[dst], ~(((uint32_t)src << 16) | word) & 0xFFFFF, 1, SIZE_ADDRESS), SIZE_ADDRESS);
+        return 3;
+
+    case 0xC:   // MOVA Rsrc,Rdst
+        setRegister(dst, reg[src], SIZE_ADDRESS);
+        return toPC ? 3 : 1;
+
+    case 0xD:   // CMPA Rsrc,Rdst
+        addWithFlags(reg[dst], ~reg[src] & 0xFFFFF, 1, SIZE_ADDRESS);
+        return 1;
+
+    case 0xE:   // ADDA Rsrc,Rdst
+        setRegister(dst, addWithFlags(reg[dst], reg[src], 0, SIZE_ADDRESS), SIZE_ADDRESS);
+        return 1;
+
+    default:    // SUBA Rsrc,Rdst
+        setRegister(dst, addWithFlags(reg[dst], ~reg[src] & 0xFFFFF, 1, SIZE_ADDRESS), SIZE_ADDRESS);
+        return 1;
+    }
+}
+
+// CALLA in all its addressing modes (opcodes 0x1340-0x13BF)
+static uint16_t callAddress(uint16_t op, uint32_t address)
+{
+    uint8_t r = op & 0xF;
+    uint32_t target;
+    uint32_t base;
+    uint16_t word;
+    uint16_t cycles = 5;
+
+    switch ((op >> 4) & 0xF)
+    {
+    case 0x4:   // CALLA Rdst
+        target = reg[r];
+        break;
+    case 0x5:   // CALLA X(Rdst)
+        word = fetch();
+        target = readAddress(reg[r] + signExtend16(word));
+        break;
+    case 0x6:   // CALLA @Rdst
+        target = readAddress(reg[r]);
+        break;
+    case 0x7:   // CALLA @Rdst+
+        target = readAddress(reg[r]);
+        reg[r] = (reg[r] + 4) & EMU_ADDRESS_MASK;
+        break;
+    case 0x8:   // CALLA &abs20
+        word = fetch();
+        target = readAddress(((uint32_t)r << 16) | word);
+        cycles = 6;
+        break;
+    case 0x9:   // CALLA EDE
+        base = PC;
+        word = fetch();
+        target = readAddress(base + (((uint32_t)r << 16) | word));
+        cycles = 6;
+        break;
+    case 0xB:   // CALLA #imm20
+        word = fetch();
+        target = ((uint32_t)r << 16) | word;
+        break;
+    default:
+        halt("invalid instruction", address);
+        return 1;
+    }
+
+    SP = (SP - 4) & EMU_ADDRESS_MASK;
+    writeAddress(SP, PC);
+    PC = target & EMU_ADDRESS_MASK & ~1UL;
+    callPending = 1;
+    return cycles;
+}
+
+// PUSHM and POPM (opcodes 0x1400-0x17FF)
+static uint16_t pushPopMultiple(uint16_t op)
+{
+    uint8_t count = ((op >> 4) & 0xF) + 1;
+    uint8_t r = op & 0xF;
+    uint8_t i;
+
+    switch ((op >> 8) & 3)
+    {
+    case 0:     // PUSHM.A #n,Rdst pushes Rdst, Rdst-1, ...
+        for (i = 0; i < count; i++)
+        {
+            SP = (SP - 4) & EMU_ADDRESS_MASK;
+            writeAddress(SP, reg[(r - i) & 0xF]);
+        }
+        return 2 + 2 * count;
+    case 1:     // PUSHM.W
+        for (i = 0; i < count; i++)
+        {
+            SP = (SP - 2) & EMU_ADDRESS_MASK;
+            writeWord(SP, (uint16_t)reg[(r - i) & 0xF]);
+        }
+        return 2 + count;
+    case 2:     // POPM.A; the encoded register is the lowest one popped
+        for (i = 0; i < count; i++)
+        {
+            setRegister((r + i) & 0xF, readAddress(SP), SIZE_ADDRESS);
+            SP = (SP + 4) & EMU_ADDRESS_MASK;
+        }
+        return 2 + 2 * count;
+    default:    // POPM.W
+        for (i = 0; i < count; i++)
+        {
+            setRegister((r + i) & 0xF, readWord(SP), SIZE_WORD);
+            SP = (SP + 2) & EMU_ADDRESS_MASK;
+        }
+        return 2 + count;
+    }
+}
+
+static uint16_t returnFromInterrupt(void)
+{
+    uint16_t status = readWord(SP);
+    uint16_t low = readWord(SP + 2);
+
+    SP = (SP + 4) & EMU_ADDRESS_MASK;
+    SR = status & 0x0FFF;
+    PC = ((uint32_t)(status & 0xF000) << 4) | low;
+    return RETI_CYCLES;
+}
+
+static uint16_t execute(uint16_t op, uint32_t address)
+{
+    uint16_t next;
+
+    if (op >= 0x4000)
+    {
+        return formatOne(op, 0, 0);
+    }
+    if (op >= 0x2000)
+    {
+        return jump(op, address);
+    }
+    if (op >= 0x1800)
+    {
+        // Extension word, the instruction it extends follows
+        next = fetch();
+        if (next >= 0x4000)
+        {
+            return formatOne(next, 1, op);
+        }
+        if (next >= 0x1000 && next < 0x1280)
+        {
+            return formatTwo(next, 1, op);
+        }
+        halt("invalid extended instruction", address);
+        return 1;
+    }
+    if (op >= 0x1400)
+    {
+        return pushPopMultiple(op);
+    }
+    if (op >= 0x1000)
+    {
+        if (op < 0x1300)
+        {
+            return formatTwo(op, 0, 0);
+        }
+        if (op == 0x1300)
+        {
+            return returnFromInterrupt();
+        }
+        return callAddress(op, address);
+    }
+    return addressInstruction(op);
+}
+
+/************************************************************
+* CONTROL
+************************************************************/
+
+void emuCoreReset(void)
+{
+    uint8_t i;
+
+    for (i = 0; i < 16; i++)
+    {
+        reg[i] = 0;
+    }
+    PC = readWord(EMU_RESET_VECTOR);
+    haltReason = 0;
+}
+
+uint16_t emuCoreStep(void)
+{
+    uint32_t address;
+    uint16_t vector;
+    uint16_t cycles;
+
+    if (haltReason)
+    {
+        return 0;
+    }
+
+    if (SR & EMU_SR_GIE)
+    {
+        vector = emuPendingInterrupt();
+        if (vector)
+        {
+            // Push the PC, then the SR with PC bits 19:16 in its top nibble
+            SP = (SP - 2) & EMU_ADDRESS_MASK;
+            writeWord(SP, (uint16_t)PC);
+            SP = (SP - 2) & EMU_ADDRESS_MASK;
+            writeWord(SP, (uint16_t)(((PC >> 4) & 0xF000) | (SR & 0x0FFF)));
+            SR &= EMU_SR_SCG0;
+            PC = readWord(vector);
+            emuAcknowledgeInterrupt(vector);
+            emuProfileCall(PC, SP);
+            emuProfileInstruction(PC, INTERRUPT_CYCLES);
+            return INTERRUPT_CYCLES;
+        }
+    }
+
+    if (SR & EMU_SR_CPUOFF)
+    {
+        return 0;
+    }
+
+    address = PC;
+    cycles = execute(fetch(), address);
+
+    // A call instruction counts to the caller, a return to the callee
+    emuProfileInstruction(address, cycles);
+    emuProfileStack(SP);
+    if (callPending)
+    {
+        emuProfileCall(PC, SP);
+        callPending = 0;
+    }
+    return cycles;
+}
+
+uint32_t emuCoreRegister(uint8_t number)
+{
+    return reg[number & 0xF];
+}
+
+void emuCoreSetRegister(uint8_t number, uint32_t value)
+{
+    reg[number & 0xF] = value & EMU_ADDRESS_MASK;
+}
+
+const char *emuCoreHalted(void)
+{
+    return haltReason;
+}
+
+#endif
@@ -0,0 +1,311 @@
+/******************************************************************************
+ *
+ * FILE: host/emuElf.c
+ *
+ * DESCRIPTION:
+ *   Loads the linked firmware into the emulator and keeps the per-function
+ *   cycle profile.
+ *   - The PT_LOAD segments of the ELF file go to their load addresses.
+ *   - Function symbols (without the compiler's $C$L labels) give every code
+ *     address an owner. Symbols of size 0 run up to the next function.
+ *   - Every instruction's cycles go to the function it belongs to (self
+ *     cycles). Calls and interrupts open a frame that closes when the
+ *     stack pointer climbs back above it, which gives the inclusive
+ *     cycles of each function and ISR, callees included.
+ *
+ * CREATED BY:
+ *   Hanna Szalai & Haroun Riahi
+ *
+ ******************************************************************************/
+
+#ifdef HAL_HOST
+
+#include <elf.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "emu.h"
+
+#define MAX_SYMBOLS         4096
+#define MAX_FRAMES          256
+
+typedef struct
+{
+    const char *name;
+    uint32_t address;
+    uint32_t size;
+    uint8_t  isFunction;
+} Symbol;
+
+typedef struct
+{
+    const char *name;
+    uint32_t address;
+    unsigned long calls;
+    uint64_t selfCycles;
+    uint64_t totalCycles;
+    uint16_t depth;             // Open frames of this function (recursion)
+} Function;
+
+typedef struct
+{
+    uint16_t function;
+    uint32_t sp;                // Stack pointer right after the call
+    uint64_t startCycles;
+} Frame;
+
+static Symbol symbols[MAX_SYMBOLS];
+static uint16_t symbolCount = 0;
+
+// Function 0 collects code without a symbol
+static Function functions[MAX_SYMBOLS + 1];
+static uint16_t functionCount = 1;
+static uint16_t functionAt[EMU_MEMORY_SIZE];
+
+static Frame frames[MAX_FRAMES];
+static uint16_t frameCount = 0;
+static uint64_t profileCycles = 0;
+
+static char *image = 0;
+
+/************************************************************
+* LOADING
+************************************************************/
+
+static int compareFunctions(const void *a, const void *b)
+{
+    const Function *left = a;
+    const Function *right = b;
+
+    return (left->address > right->address) - (left->address < right->address);
+}
+
+// Gives every code address the index of the function that owns it
+static void mapFunctions(void)
+{
+    uint16_t i;
+    uint16_t j;
+    uint32_t end;
+    uint32_t address;
+
+    functions[0].name = "(no symbol)";
+    for (i = 0; i < symbolCount; i++)
+    {
+        if (symbols[i].isFunction)
+        {
+            functions[functionCount].name = symbols[i].name;
+            functions[functionCount].address = symbols[i].address;
+            functionCount++;
+        }
+    }
+    qsort(&functions[1], functionCount - 1, sizeof(Function), compareFunctions);
+
+    for (i = 1; i < functionCount; i++)
+    {
+        end = (i + 1 < functionCount) ? functions[i + 1].address : functions[i].address + 2;
+        for (j = 0; j < symbolCount; j++)
+        {
+            if (symbols[j].isFunction && symbols[j].address == functions[i].address
+                && symbols[j].size && functions[i].address + symbols[j].size < end)
+            {
+                end = functions[i].address + symbols[j].size;
+            }
+        }
+        for (address = functions[i].address; address < end && address < EMU_MEMORY_SIZE; address++)
+        {
+            functionAt[address] = i;
+        }
+    }
+}
+
+int emuLoadElf(const char *path)
+{
+    FILE *file = fopen(path, "rb");
+    const Elf32_Ehdr *header;
+    const Elf32_Phdr *program;
+    const Elf32_Shdr *sections;
+    const Elf32_Sym *entries;
+    const char *names;
+    long length;
+    uint16_t i;
+    uint32_t j;
+
+    if (!file)
+    {
+        perror(path);
+        return -1;
+    }
+    fseek(file, 0, SEEK_END);
+    length = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    image = malloc(length);
+    if (!image || fread(image, 1, length, file) != (size_t)length)
+    {
+        fclose(file);
+        fprintf(stderr, "%s: cannot read the file\n", path);
+        return -1;
+    }
+    fclose(file);
+
+    header = (const Elf32_Ehdr *)image;
+    if (length < (long)sizeof(Elf32_Ehdr) || memcmp(header->e_ident, ELFMAG, SELFMAG) != 0
+        || header->e_ident[EI_CLASS] != ELFCLASS32 || header->e_machine != EM_MSP430)
+    {
+        fprintf(stderr, "%s: not an MSP430 ELF file\n", path);
+        return -1;
+    }
+
+    // Program image
+    for (i = 0; i < header->e_phnum; i++)
+    {
+        program = (const Elf32_Phdr *)(image + header->e_phoff + i * header->e_phentsize);
+        if (program->p_type != PT_LOAD || program->p_paddr + program->p_memsz > EMU_MEMORY_SIZE)
+        {
+            continue;
+        }
+        memset(&emuMemory[program->p_paddr], 0, program->p_memsz);
+        memcpy(&emuMemory[program->p_paddr], image + program->p_offset, program->p_filesz);
+    }
+
+    // Symbol table
+    sections = (const Elf32_Shdr *)(image + header->e_shoff);
+    for (i = 0; i < header->e_shnum; i++)
+    {
+        if (sections[i].sh_type != SHT_SYMTAB)
+        {
+            continue;
+        }
+        entries = (const Elf32_Sym *)(image + sections[i].sh_offset);
+        names = image + sections[sections[i].sh_link].sh_offset;
+        for (j = 0; j < sections[i].sh_size / sizeof(Elf32_Sym) && symbolCount < MAX_SYMBOLS; j++)
+        {
+            const char *name = names + entries[j].st_name;
+            uint8_t type = ELF32_ST_TYPE(entries[j].st_info);
+
+            if (!name[0] || name[0] == '$' || (type != STT_FUNC && type != STT_OBJECT))
+            {
+                continue;
+            }
+            symbols[symbolCount].name = name;
+            symbols[symbolCount].address = entries[j].st_value;
+            symbols[symbolCount].size = entries[j].st_size;
+            symbols[symbolCount].isFunction = (type == STT_FUNC);
+            symbolCount++;
+        }
+    }
+
+    mapFunctions();
+    return 0;
+}
+
+uint32_t emuSymbolAddress(const char *name)
+{
+    uint16_t i;
+
+    for (i = 0; i < symbolCount; i++)
+    {
+        if (strcmp(symbols[i].name, name) == 0)
+        {
+            return symbols[i].address;
+        }
+    }
+    return 0;
+}
+
+/************************************************************
+* PROFILE
+************************************************************/
+
+void emuProfileInstruction(uint32_t pc, uint16_t cycles)
+{
+    profileCycles += cycles;
+    functions[functionAt[pc & EMU_ADDRESS_MASK]].selfCycles += cycles;
+}
+
+void emuProfileCall(uint32_t target, uint32_t sp)
+{
+    uint16_t function = functionAt[target & EMU_ADDRESS_MASK];
+
+    functions[function].calls++;
+    if (frameCount == MAX_FRAMES)
+    {
+        return;
+    }
+    frames[frameCount].function = function;
+    frames[frameCount].sp = sp;
+    frames[frameCount].startCycles = profileCycles;
+    frameCount++;
+    functions[function].depth++;
+}
+
+// Closes the frames whose return address has been popped
+void emuProfileStack(uint32_t sp)
+{
+    Function *function;
+
+    while (frameCount && frames[frameCount - 1].sp < sp)
+    {
+        frameCount--;
+        function = &functions[frames[frameCount].function];
+        function->depth--;
+        if (!function->depth)
+        {
+            function->totalCycles += profileCycles - frames[frameCount].startCycles;
+        }
+    }
+}
+
+static int compareTotals(const void *a, const void *b)
+{
+    const Function *left = *(const Function * const *)a;
+    const Function *right = *(const Function * const *)b;
+
+    return (left->totalCycles < right->totalCycles) - (left->totalCycles > right->totalCycles);
+}
+
+void emuProfileReport(uint64_t totalCycles)
+{
+    static Function *sorted[MAX_SYMBOLS + 1];
+    uint16_t count = 0;
+    uint16_t i;
+
+    // Functions still running (main, an interrupted ISR) count up to now
+    for (i = 0; i < frameCount; i++)
+    {
+        Function *function = &functions[frames[i].function];
+
+        if (function->depth)
+        {
+            function->totalCycles += profileCycles - frames[i].startCycles;
+            function->depth = 0;
+        }
+    }
+    frameCount = 0;
+
+    for (i = 0; i < functionCount; i++)
+    {
+        if (functions[i].selfCycles)
+        {
+            if (functions[i].totalCycles < functions[i].selfCycles)
+            {
+                functions[i].totalCycles = functions[i].selfCycles;
+            }
+            sorted[count++] = &functions[i];
+        }
+    }
+    qsort(sorted, count, sizeof(sorted[0]), compareTotals);
+
+    printf("%-34s %10s %14s %14s %12s %7s\n",
+           "function", "calls", "self cycles", "total cycles", "cycles/call", "total%");
+    for (i = 0; i < count; i++)
+    {
+        printf("%-34s %10lu %14llu %14llu %12llu %6.2f%%\n",
+               sorted[i]->name, sorted[i]->calls,
+               (unsigned long long)sorted[i]->selfCycles,
+               (unsigned long long)sorted[i]->totalCycles,
+               (unsigned long long)(sorted[i]->calls ? sorted[i]->totalCycles / sorted[i]->calls : 0),
+               totalCycles ? 100.0 * sorted[i]->totalCycles / totalCycles : 0.0);
+    }
+}
+
+#endif
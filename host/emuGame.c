@@ -0,0 +1,228 @@
+/******************************************************************************
+ *
+ * FILE: host/emuGame.c
+ *
+ * DESCRIPTION:
+ *   Runs the linked firmware on the MSP430X emulator and plays it with the
+ *   scripted player from player.c, then prints how many CPU cycles each
+ *   function and ISR took. The numbers are the board's own: the emulator
+ *   executes the same .out file that is flashed on the LaunchPad.
+ *
+ *   The cycles and the simulated time are also charged to the game phase
+ *   the player is in (player.h), which gives the CPU-active time of each
+ *   phase the firmware reports over the UART, for any image: old images
+ *   that do not measure it themselves can be compared with new ones.
+ *
+ *   The player reads the score with the CharMap table and the digit glyphs
+ *   it finds in the firmware's symbol table: the digit table of older
+ *   images, or the '0' to '9' entries of lcdGlyphs.
+ *
+ * BUILD AND RUN (from the repository root):
+ *   gcc -O2 -DHAL_HOST -Ihost host/emuCore.c host/emuPeripherals.c \
+ *       host/emuElf.c host/player.c host/emuGame.c -o msp430Emu
+ *   ./msp430Emu [-g games] [-s seed] [-t seconds] [-u] [firmware.out]
+ *
+ *   -g  games to play (default 3)
+ *   -s  seed for the rounds the player makes its mistakes in
+ *   -t  stop after this many simulated seconds, games or not
+ *   -u  echo what the firmware sends on the UART
+ *   The firmware defaults to Debug/HH_memorygameproject.out.
+ *
+ * CREATED BY:
+ *   Hanna Szalai & Haroun Riahi
+ *
+ ******************************************************************************/
+
+#ifdef HAL_HOST
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "emu.h"
+#include "player.h"
+
+#define DEFAULT_FIRMWARE    "Debug/HH_memorygameproject.out"
+
+// The player looks at the board this often
+#define INPUT_MS            10
+
+static const char * const phaseNames[PLAYER_PHASE_COUNT] =
+{
+    "INTRO", "BANNER", "PLAYBACK", "INPUT", "GAMEOVER"
+};
+
+static int stopped = 0;
+static int stopCode = 0;
+
+static uint64_t phaseCycles[PLAYER_PHASE_COUNT];
+static uint32_t phaseMs[PLAYER_PHASE_COUNT];
+
+static void stopRun(int code)
+{
+    stopped = 1;
+    stopCode = code;
+}
+
+static void echoUart(uint8_t byte)
+{
+    putchar(byte);
+}
+
+// CPU cycles, time and share of the time awake of every game phase
+static void reportPhases(void)
+{
+    double mclk = emuMclkFrequency();
+    int phase;
+
+    printf("phase        CPU cycles    time (s)   awake\n");
+    for (phase = 0; phase < PLAYER_PHASE_COUNT; phase++)
+    {
+        printf("%-10s %12llu %11.3f %6.2f%%\n", phaseNames[phase],
+               (unsigned long long)phaseCycles[phase], phaseMs[phase] / 1000.0,
+               phaseMs[phase] ? 100.0 * phaseCycles[phase] / (mclk * phaseMs[phase] / 1000.0) : 0.0);
+    }
+    printf("\n");
+}
+
+int main(int argc, char *argv[])
+{
+    const char *firmware = DEFAULT_FIRMWARE;
+    unsigned long games = 3;
+    uint32_t seed = 1;
+    uint32_t limitMs = 0;
+    uint32_t nextInput = INPUT_MS;
+    uint32_t lastMs = 0;
+    uint64_t activeCycles = 0;
+    uint8_t phase = PLAYER_PHASE_INTRO;
+    uint32_t charMap;
+    uint32_t digits;
+    PlayerView board;
+    clock_t started;
+    double seconds;
+    uint16_t cycles;
+    uint16_t sr;
+    const char *halted;
+    int i;
+
+    for (i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-g") == 0 && i + 1 < argc)
+        {
+            games = strtoul(argv[++i], NULL, 10);
+        }
+        else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc)
+        {
+            seed = strtoul(argv[++i], NULL, 10);
+        }
+        else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc)
+        {
+            limitMs = strtoul(argv[++i], NULL, 10) * 1000;
+        }
+        else if (strcmp(argv[i], "-u") == 0)
+        {
+            emuSetUartOutput(echoUart);
+        }
+        else if (argv[i][0] == '-')
+        {
+            fprintf(stderr, "usage: %s [-g games] [-s seed] [-t seconds] [-u] [firmware.out]\n", argv[0]);
+            return 2;
+        }
+        else
+        {
+            firmware = argv[i];
+        }
+    }
+
+    if (emuLoadElf(firmware) != 0)
+    {
+        return 2;
+    }
+    charMap = emuSymbolAddress("CharMap");
+    digits = emuSymbolAddress("digit");
+    if (!digits && emuSymbolAddress("lcdGlyphs"))
+    {
+        digits = emuSymbolAddress("lcdGlyphs") + '0' * 2;
+    }
+    if (!charMap || !digits)
+    {
+        fprintf(stderr, "%s: no CharMap or digit glyphs to read the LCD with\n", firmware);
+        return 2;
+    }
+
+    board.leds = emuLeds;
+    board.lcdMemory = emuLcdMemory;
+    board.charMap = &emuMemory[charMap];
+    board.digits = &emuMemory[digits];
+    board.stop = stopRun;
+
+    emuPeripheralsReset();
+    emuCoreReset();
+    playerStart(&board, games, seed);
+
+    started = clock();
+    while (!stopped)
+    {
+        cycles = emuCoreStep();
+        sr = (uint16_t)emuCoreRegister(2);
+
+        if (cycles)
+        {
+            activeCycles += cycles;
+            phaseCycles[phase] += cycles;
+            emuPeripheralsAdvance(cycles, sr);
+        }
+        else if ((halted = emuCoreHalted()) != 0)
+        {
+            printf("firmware stopped: %s\n", halted);
+            stopCode = 3;
+            break;
+        }
+        else if (!(sr & EMU_SR_GIE))
+        {
+            printf("firmware stopped: sleeping with interrupts disabled at 0x%05lX\n",
+                   (unsigned long)emuCoreRegister(0));
+            stopCode = 3;
+            break;
+        }
+        else
+        {
+            // Low-power mode: let the clocks run until something wakes the CPU
+            emuPeripheralsAdvance(emuSleepStep(sr), sr);
+        }
+
+        phaseMs[phase] += emuTimeMs() - lastMs;
+        lastMs = emuTimeMs();
+
+        while (emuTimeMs() >= nextInput && !stopped)
+        {
+            emuSetButtons(playerButtons(nextInput));
+            nextInput += INPUT_MS;
+        }
+        phase = playerPhase();
+        if (limitMs && emuTimeMs() >= limitMs)
+        {
+            break;
+        }
+    }
+    seconds = (double)(clock() - started) / CLOCKS_PER_SEC;
+
+    printf("\nfirmware:       %s\n", firmware);
+    printf("games played:   %lu\n", playerGamesPlayed());
+    printf("failures:       %lu\n", playerFailures());
+    printf("simulated time: %.3f s\n", emuTimeMs() / 1000.0);
+    printf("first frame:    %.3f ms after reset\n", emuFirstFrameUs() / 1000.0);
+    printf("CPU cycles:     %llu (%.1f%% of the time awake at %lu Hz MCLK)\n",
+           (unsigned long long)activeCycles,
+           emuTimeMs() ? 100.0 * activeCycles / ((double)emuMclkFrequency() * emuTimeMs() / 1000.0) : 0.0,
+           (unsigned long)emuMclkFrequency());
+    printf("host time:      %.2f s (%.1f million cycles/s)\n\n",
+           seconds, seconds > 0 ? activeCycles / seconds / 1e6 : 0.0);
+
+    reportPhases();
+    emuProfileReport(activeCycles);
+
+    return stopCode ? stopCode : (playerFailures() ? 1 : 0);
+}
+
+#endif
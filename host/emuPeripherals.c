@@ -0,0 +1,1415 @@
+/******************************************************************************
+ *
+ * FILE: host/emuPeripherals.c
+ *
+ * DESCRIPTION:
+ *   Peripherals of the instruction-set emulator, at their FR6989
+ *   addresses. Registers without behaviour below read back what was
+ *   written, so the rest of the chip looks like plain RAM.
+ *   - CS:       DCO, VLO, MODCLK and an LFXT crystal that needs
+ *               EMU_LFXT_START_MS to start; clock frequencies follow the
+ *               CSCTLx settings and the low-power bits in SR
+ *   - GPIO:     port 1 buttons with edge flags, P1IV and the PORT1 vector
+ *   - Timer_A0-A3 and Timer_B0: up, continuous and up/down modes, compare
+ *               and software capture, TAxIV and both vectors of each timer
+ *   - eUSCI_A0/A1 UART: frame time from UCBRx/UCBRFx/UCBRSx, one byte in
+ *               TXBUF and one in the shift register, UCAxIV
+ *   - DMA:      three channels, single and repeated single transfers,
+ *               triggered by DMAREQ or a rising UCA1TXIFG; each transfer
+ *               holds the bus for EMU_DMA_CYCLES MCLK cycles
+ *   - MPY32:    16 and 32-bit signed/unsigned multiply and accumulate
+ *   - CRC16:    CRC-CCITT of bytes and words written to CRCDI (LSB first)
+ *               or CRCDIRB (MSB first), result in CRCINIRES and CRCRESR
+ *   - LCD_C:    LCDCLRM/LCDCLRBM and the LCDDISP memory select; the time
+ *               the first segment is shown is kept as the boot time
+ *
+ * CREATED BY:
+ *   Hanna Szalai & Haroun Riahi
+ *
+ ******************************************************************************/
+
+#ifdef HAL_HOST
+
+#include "emu.h"
+
+#define REG8(address)       emuMemory[(address)]
+#define REG16(address)      (*(uint16_t *)&emuMemory[(address)])
+
+// How long the 32768 Hz crystal takes to start once it is enabled
+#define EMU_LFXT_START_MS   250
+
+// Internal oscillators
+#define VLO_HZ              9400
+#define MODCLK_HZ           5000000
+#define LFMODCLK_HZ         (MODCLK_HZ / 128)
+#define LFXT_HZ             32768
+
+// SFR and PMM
+#define SFRIFG1             0x0102
+#define OFIFG               0x0002
+#define PM5CTL0             0x0130
+#define LOCKLPM5            0x0001
+
+// CS
+#define CSCTL1              0x0162
+#define CSCTL2              0x0164
+#define CSCTL3              0x0166
+#define CSCTL4              0x0168
+#define CSCTL5              0x016A
+#define LFXTOFF             0x0001
+#define HFXTOFF             0x0100
+#define LFXTOFFG            0x0001
+#define HFXTOFFG            0x0002
+#define DCORSEL             0x0040
+
+// CRC16
+#define CRCDI               0x0150
+#define CRCDIRB             0x0152
+#define CRCINIRES           0x0154
+#define CRCRESR             0x0156
+#define CRC_POLYNOMIAL      0x1021
+
+// WDT
+#define WDTCTL              0x015C
+
+// Ports
+#define P1IN                0x0200
+#define P1OUT               0x0202
+#define P1DIR               0x0204
+#define P1IV                0x020E
+#define P1IES               0x0218
+#define P1IE                0x021A
+#define P1IFG               0x021C
+#define P9OUT               0x0282
+#define P9DIR               0x0284
+#define PJSEL0              0x032A
+#define PORT1_VECTOR        0xFFDA
+
+// Timer register offsets and bits (Timer_A and Timer_B share them)
+#define TIMER_CTL           0x00
+#define TIMER_CCTL0         0x02
+#define TIMER_R             0x10
+#define TIMER_CCR0          0x12
+#define TIMER_EX0           0x20
+#define TIMER_IV            0x2E
+#define TIMER_IFG           0x0001
+#define TIMER_IE            0x0002
+#define TIMER_CLR           0x0004
+#define TIMER_CNTL          0x1800
+#define CC_IFG              0x0001
+#define CC_COV              0x0002
+#define CC_IE               0x0010
+#define CC_CAP              0x0100
+#define CC_CCIS             0x3000
+#define CC_CM               0xC000
+
+// MPY32
+#define MPY_BASE            0x04C0
+#define MPY_MPY             0x00
+#define MPY_MPYS            0x02
+#define MPY_MAC             0x04
+#define MPY_MACS            0x06
+#define MPY_OP2             0x08
+#define MPY_RESLO           0x0A
+#define MPY_RESHI           0x0C
+#define MPY_SUMEXT          0x0E
+#define MPY_MPY32L          0x10
+#define MPY_MACS32H         0x1E
+#define MPY_OP2L            0x20
+#define MPY_OP2H            0x22
+#define MPY_RES0            0x24
+#define MPY_CTL0            0x2C
+#define MPYC                0x0001
+#define MPYOP1_32           0x0040
+#define MPYOP2_32           0x0080
+
+// eUSCI_A register offsets and bits
+#define UART_CTLW0          0x00
+#define UART_BRW            0x06
+#define UART_MCTLW          0x08
+#define UART_RXBUF          0x0C
+#define UART_TXBUF          0x0E
+#define UART_IE             0x1A
+#define UART_IFG            0x1C
+#define UART_IV             0x1E
+#define UCSWRST             0x0001
+#define UCSPB               0x0800
+#define UC7BIT              0x1000
+#define UCPEN               0x8000
+#define UCOS16              0x0001
+#define UCRXIFG             0x0001
+#define UCTXIFG             0x0002
+#define UCTXCPTIFG          0x0008
+
+// DMA
+#define DMA_BASE            0x0500
+#define DMA_CTL0            0x00
+#define DMA_IV              0x0E
+#define DMA_CHANNEL0        0x10
+#define DMA_CHANNEL_COUNT   3
+#define DMA_CTL             0x00
+#define DMA_SA              0x02
+#define DMA_DA              0x06
+#define DMA_SZ              0x0A
+#define DMAREQ              0x0001
+#define DMAIE               0x0004
+#define DMAIFG              0x0008
+#define DMAEN               0x0010
+#define DMASRCBYTE          0x0040
+#define DMADSTBYTE          0x0080
+#define DMASRCINCR          0x0300
+#define DMADSTINCR          0x0C00
+#define DMADT_REPEATED      0x4000
+#define DMA_TRIGGER_DMAREQ  0
+#define DMA_TRIGGER_UCA1TX  17
+#define DMA_VECTOR          0xFFE0
+#define EMU_DMA_CYCLES      2
+
+// LCD_C
+#define LCDCCTL0            0x0A00
+#define LCDON               0x0004
+#define LCDCMEMCTL          0x0A06
+#define LCDDISP             0x0001
+#define LCDCLRM             0x0002
+#define LCDCLRBM            0x0004
+#define LCDM1               0x0A20
+#define LCDBM1              0x0A40
+#define LCD_MEMORY_SIZE     32
+
+typedef struct
+{
+    uint16_t base;
+    uint8_t  ccrCount;
+    uint16_t vector0;           // CCR0
+    uint16_t vector1;           // CCR1-n and overflow
+    uint8_t  countingDown;
+    uint64_t phase;             // Clock accumulator in MCLK units
+} Timer;
+
+typedef struct
+{
+    uint16_t base;
+    uint16_t vector;
+    uint8_t  shifting;          // A frame is on the wire
+    uint8_t  bufferFull;        // Another byte waits in TXBUF
+    uint8_t  buffered;
+    uint32_t frameLeft;         // BRCLK cycles left of the current frame
+    uint64_t phase;
+} Uart;
+
+typedef struct
+{
+    uint32_t source;            // Addresses and size of the transfer running,
+    uint32_t destination;       // reloaded from the registers when it ends
+    uint16_t left;
+} DmaChannel;
+
+static Timer timers[] =
+{
+    { 0x0340, 3, 0xFFE8, 0xFFE6, 0, 0 },    // Timer0_A3
+    { 0x0380, 3, 0xFFDE, 0xFFDC, 0, 0 },    // Timer1_A3
+    { 0x0400, 2, 0xFFD8, 0xFFD6, 0, 0 },    // Timer2_A2
+    { 0x0440, 5, 0xFFD2, 0xFFD0, 0, 0 },    // Timer3_A5
+    { 0x03C0, 7, 0xFFF6, 0xFFF4, 0, 0 }     // Timer0_B7
+};
+#define TIMER_COUNT         (sizeof(timers) / sizeof(timers[0]))
+#define TIMER_B0            (&timers[4])
+
+static Uart uarts[] =
+{
+    { 0x05C0, 0xFFEE, 0, 0, 0, 0, 0 },      // eUSCI_A0
+    { 0x05E0, 0xFFE4, 0, 0, 0, 0, 0 }       // eUSCI_A1
+};
+#define UART_COUNT          (sizeof(uarts) / sizeof(uarts[0]))
+
+static DmaChannel dmaChannels[DMA_CHANNEL_COUNT];
+static uint32_t dmaCycles = 0;          // MCLK cycles the DMA held the bus
+
+// DCO frequencies for DCOFSEL 0-7 with DCORSEL clear and set
+static const uint32_t dcoFrequency[2][8] =
+{
+    { 1000000, 2670000, 3330000, 4000000, 5330000, 6670000, 8000000, 8000000 },
+    { 1000000, 5330000, 6670000, 8000000, 16000000, 21000000, 24000000, 24000000 }
+};
+
+static uint32_t aclkHz;
+static uint32_t smclkHz;
+static uint32_t mclkHz;
+
+static uint64_t timePs = 0;             // Simulated time
+static uint64_t lfxtRequestedPs = 0;    // When the crystal was enabled
+static uint8_t  lfxtRequested = 0;
+static uint8_t  lfxtRunning = 0;
+
+static uint64_t firstFramePs = 0;       // When the LCD first showed a segment
+static uint8_t  framesShown = 0;
+
+static uint8_t  buttonsHeld = 0;
+static void (*uartOutput)(uint8_t byte) = 0;
+
+static void dmaTrigger(uint8_t trigger);
+
+// Last operand 1 written to the multiplier
+static uint32_t mpyOperand1;
+static uint8_t  mpyMode;                // Offset of the OP1 register written
+
+/************************************************************
+* CLOCKS
+************************************************************/
+
+static uint32_t sourceFrequency(uint16_t select)
+{
+    switch (select)
+    {
+    case 0:  return lfxtRunning ? LFXT_HZ : LFMODCLK_HZ;  // Falls back on a fault
+    case 1:  return VLO_HZ;
+    case 2:  return LFMODCLK_HZ;
+    case 3:  return dcoFrequency[(REG16(CSCTL1) & DCORSEL) != 0][(REG16(CSCTL1) >> 1) & 0x07];
+    case 4:  return MODCLK_HZ;
+    default: return dcoFrequency[(REG16(CSCTL1) & DCORSEL) != 0][(REG16(CSCTL1) >> 1) & 0x07];
+    }
+}
+
+static void updateClocks(void)
+{
+    uint16_t select = REG16(CSCTL2);
+    uint16_t divide = REG16(CSCTL3);
+
+    aclkHz = sourceFrequency((select >> 8) & 0x07) >> ((divide >> 8) & 0x07);
+    smclkHz = sourceFrequency((select >> 4) & 0x07) >> ((divide >> 4) & 0x07);
+    mclkHz = sourceFrequency(select & 0x07) >> (divide & 0x07);
+}
+
+// The crystal runs when it is enabled (or used as a clock source) and its
+// pins PJ.4/PJ.5 are in crystal mode. Until it has started, the fault
+// flags come back as soon as software clears them.
+static void updateCrystal(void)
+{
+    uint16_t select = REG16(CSCTL2);
+    uint8_t wanted;
+
+    wanted = (!(REG16(CSCTL4) & LFXTOFF) || (select & 0x0700) == 0
+              || (select & 0x0070) == 0 || (select & 0x0007) == 0)
+             && (REG8(PJSEL0) & 0x10);
+
+    if (wanted && !lfxtRequested)
+    {
+        lfxtRequestedPs = timePs;
+    }
+    lfxtRequested = wanted;
+
+    if (lfxtRequested && !lfxtRunning &&
+        timePs - lfxtRequestedPs >= (uint64_t)EMU_LFXT_START_MS * 1000000000ULL)
+    {
+        lfxtRunning = 1;
+        updateClocks();
+    }
+    else if (!lfxtRequested && lfxtRunning)
+    {
+        lfxtRunning = 0;
+        updateClocks();
+    }
+
+    if (!lfxtRunning)
+    {
+        REG16(CSCTL5) |= LFXTOFFG;
+        REG16(SFRIFG1) |= OFIFG;
+    }
+    if (!(REG16(CSCTL4) & HFXTOFF))
+    {
+        // There is no high-frequency crystal on the LaunchPad
+        REG16(CSCTL5) |= HFXTOFFG;
+        REG16(SFRIFG1) |= OFIFG;
+    }
+}
+
+uint32_t emuMclkFrequency(void)
+{
+    return mclkHz;
+}
+
+uint32_t emuTimeMs(void)
+{
+    return (uint32_t)(timePs / 1000000000ULL);
+}
+
+/************************************************************
+* GPIO
+************************************************************/
+
+// Pins read back their output when driven, otherwise the pull-ups make
+// them high unless a button holds them low
+static uint8_t portOneLevel(void)
+{
+    uint8_t level = (uint8_t)~buttonsHeld;
+
+    return (level & ~REG8(P1DIR)) | (REG8(P1OUT) & REG8(P1DIR));
+}
+
+void emuSetButtons(uint8_t held)
+{
+    uint8_t before = portOneLevel();
+    uint8_t after;
+    uint8_t changed;
+
+    buttonsHeld = held;
+    after = portOneLevel();
+    changed = before ^ after;
+
+    // P1IES set means the flag is raised on a high-to-low edge
+    REG8(P1IFG) |= (changed & before & REG8(P1IES)) | (changed & after & ~REG8(P1IES));
+}
+
+uint8_t emuLeds(void)
+{
+    uint8_t leds = 0;
+
+    if (REG16(PM5CTL0) & LOCKLPM5)
+    {
+        return 0;
+    }
+    if (REG8(P1DIR) & REG8(P1OUT) & 0x01)
+    {
+        leds |= 0x01;
+    }
+    if (REG8(P9DIR) & REG8(P9OUT) & 0x80)
+    {
+        leds |= 0x02;
+    }
+    return leds;
+}
+
+uint8_t emuLcdMemory(uint8_t index)
+{
+    uint16_t memory = (REG16(LCDCMEMCTL) & LCDDISP) ? LCDBM1 : LCDM1;
+
+    return REG8(memory + index - 1);
+}
+
+// Notes the first moment the LCD is on and shows any segment
+static void checkFirstFrame(void)
+{
+    uint8_t i;
+
+    if (framesShown || !(REG16(LCDCCTL0) & LCDON))
+    {
+        return;
+    }
+    for (i = 1; i <= LCD_MEMORY_SIZE; i++)
+    {
+        if (emuLcdMemory(i))
+        {
+            firstFramePs = timePs;
+            framesShown = 1;
+            return;
+        }
+    }
+}
+
+uint32_t emuFirstFrameUs(void)
+{
+    return (uint32_t)(firstFramePs / 1000000ULL);
+}
+
+// Highest-priority pending port 1 interrupt as a P1IV value; clears it
+static uint16_t portOneVector(uint8_t clear)
+{
+    uint8_t pending = REG8(P1IFG) & REG8(P1IE);
+    uint8_t pin;
+
+    for (pin = 0; pin < 8; pin++)
+    {
+        if (pending & (1 << pin))
+        {
+            if (clear)
+            {
+                REG8(P1IFG) &= ~(1 << pin);
+            }
+            return 2 * (pin + 1);
+        }
+    }
+    return 0;
+}
+
+/************************************************************
+* TIMERS
+************************************************************/
+
+static uint16_t timerCounterMask(const Timer *timer)
+{
+    static const uint16_t lengths[4] = { 0xFFFF, 0x0FFF, 0x03FF, 0x00FF };
+
+    if (timer == TIMER_B0)
+    {
+        return lengths[(REG16(timer->base + TIMER_CTL) & TIMER_CNTL) >> 11];
+    }
+    return 0xFFFF;
+}
+
+static uint32_t timerClock(const Timer *timer, uint16_t sr)
+{
+    uint16_t control = REG16(timer->base + TIMER_CTL);
+
+    if (!(control & 0x0030))
+    {
+        return 0;
+    }
+    switch ((control >> 8) & 3)
+    {
+    case 1:  return (sr & EMU_SR_OSCOFF) ? 0 : aclkHz;
+    case 2:  return (sr & EMU_SR_SCG1) ? 0 : smclkHz;
+    default: return 0;      // No TACLK or INCLK on the board
+    }
+}
+
+static uint32_t timerDivider(const Timer *timer)
+{
+    return (1U << ((REG16(timer->base + TIMER_CTL) >> 6) & 3))
+           * ((REG16(timer->base + TIMER_EX0) & 7) + 1);
+}
+
+static void timerTick(Timer *timer)
+{
+    uint16_t base = timer->base;
+    uint16_t counter = REG16(base + TIMER_R);
+    uint16_t period = REG16(base + TIMER_CCR0);
+    uint16_t mask = timerCounterMask(timer);
+    uint8_t n;
+
+    switch ((REG16(base + TIMER_CTL) >> 4) & 3)
+    {
+    case 1:     // Up to TAxCCR0
+        if (period == 0)
+        {
+            return;
+        }
+        if (counter >= period)
+        {
+            counter = 0;
+            REG16(base + TIMER_CTL) |= TIMER_IFG;
+        }
+        else
+        {
+            counter++;
+        }
+        break;
+
+    case 2:     // Continuous
+        counter = (counter + 1) & mask;
+        if (counter == 0)
+        {
+            REG16(base + TIMER_CTL) |= TIMER_IFG;
+        }
+        break;
+
+    default:    // Up/down
+        if (!timer->countingDown)
+        {
+            if (counter >= period)
+            {
+                timer->countingDown = 1;
+                counter--;
+            }
+            else
+            {
+                counter++;
+            }
+        }
+        else if (counter == 0)
+        {
+            timer->countingDown = 0;
+            counter++;
+        }
+        else
+        {
+            counter--;
+            if (counter == 0)
+            {
+                REG16(base + TIMER_CTL) |= TIMER_IFG;
+            }
+        }
+        break;
+    }
+
+    REG16(base + TIMER_R) = counter;
+
+    // Compare channels flag when the counter reaches their value
+    for (n = 0; n < timer->ccrCount; n++)
+    {
+        uint16_t control = base + TIMER_CCTL0 + 2 * n;
+
+        if (!(REG16(control) & CC_CAP) && counter == REG16(base + TIMER_CCR0 + 2 * n))
+        {
+            REG16(control) |= CC_IFG;
+        }
+    }
+}
+
+static void timerAdvance(Timer *timer, uint32_t cycles, uint16_t sr)
+{
+    uint32_t clock = timerClock(timer, sr);
+    uint64_t period;
+
+    if (!clock || !mclkHz)
+    {
+        return;
+    }
+
+    period = (uint64_t)mclkHz * timerDivider(timer);
+    timer->phase += (uint64_t)cycles * clock;
+    while (timer->phase >= period)
+    {
+        timer->phase -= period;
+        timerTick(timer);
+    }
+}
+
+// Highest-priority pending CCR1-n or overflow interrupt as a TAxIV value
+static uint16_t timerVector(const Timer *timer, uint8_t clear)
+{
+    uint16_t base = timer->base;
+    uint8_t n;
+
+    for (n = 1; n < timer->ccrCount; n++)
+    {
+        uint16_t control = base + TIMER_CCTL0 + 2 * n;
+
+        if ((REG16(control) & (CC_IFG | CC_IE)) == (CC_IFG | CC_IE))
+        {
+            if (clear)
+            {
+                REG16(control) &= ~CC_IFG;
+            }
+            return 2 * n;
+        }
+    }
+    if ((REG16(base + TIMER_CTL) & (TIMER_IFG | TIMER_IE)) == (TIMER_IFG | TIMER_IE))
+    {
+        if (clear)
+        {
+            REG16(base + TIMER_CTL) &= ~TIMER_IFG;
+        }
+        return 0x0E;
+    }
+    return 0;
+}
+
+// Capture/compare control written: a capture channel switched between its
+// GND and VCC inputs by software captures on the selected edge
+static void timerControlWritten(Timer *timer, uint8_t n, uint16_t before)
+{
+    uint16_t control = timer->base + TIMER_CCTL0 + 2 * n;
+    uint16_t after = REG16(control);
+    uint8_t rising;
+    uint16_t edges;
+
+    if (!(after & CC_CAP) || (before & CC_CCIS) < 0x2000 || (after & CC_CCIS) < 0x2000
+        || (before & CC_CCIS) == (after & CC_CCIS))
+    {
+        return;
+    }
+
+    rising = (after & CC_CCIS) == 0x3000;
+    edges = (after & CC_CM) >> 14;
+    if ((rising && (edges & 1)) || (!rising && (edges & 2)))
+    {
+        if (after & CC_IFG)
+        {
+            REG16(control) |= CC_COV;
+        }
+        REG16(timer->base + TIMER_CCR0 + 2 * n) = REG16(timer->base + TIMER_R);
+        REG16(control) |= CC_IFG;
+    }
+}
+
+static Timer *timerAt(uint32_t address)
+{
+    uint8_t i;
+
+    for (i = 0; i < TIMER_COUNT; i++)
+    {
+        if (address >= timers[i].base && address < timers[i].base + 0x30u)
+        {
+            return &timers[i];
+        }
+    }
+    return 0;
+}
+
+/************************************************************
+* UART
+************************************************************/
+
+static uint32_t uartClock(const Uart *uart)
+{
+    switch ((REG16(uart->base + UART_CTLW0) >> 6) & 3)
+    {
+    case 0:  return 0;
+    case 1:  return aclkHz;
+    default: return smclkHz;
+    }
+}
+
+// BRCLK cycles of one frame: start bit, data, parity and stop bits, plus
+// the UCBRSx modulation spread over the bits
+static uint32_t uartFrameCycles(const Uart *uart)
+{
+    uint16_t control = REG16(uart->base + UART_CTLW0);
+    uint16_t modulation = REG16(uart->base + UART_MCTLW);
+    uint32_t prescaler = REG16(uart->base + UART_BRW);
+    uint32_t bitCycles;
+    uint8_t bits = 10;
+    uint8_t pattern = modulation >> 8;
+    uint8_t extra = 0;
+
+    if (control & UC7BIT)
+    {
+        bits--;
+    }
+    if (control & UCPEN)
+    {
+        bits++;
+    }
+    if (control & UCSPB)
+    {
+        bits++;
+    }
+
+    bitCycles = (modulation & UCOS16) ? prescaler * 16 + ((modulation >> 4) & 0x0F) : prescaler;
+    while (pattern)
+    {
+        extra += pattern & 1;
+        pattern >>= 1;
+    }
+
+    return bits * bitCycles + (bits * extra) / 8;
+}
+
+static void uartStartFrame(Uart *uart, uint8_t byte)
+{
+    uart->shifting = 1;
+    uart->frameLeft = uartFrameCycles(uart);
+    if (uartOutput && uart->base == uarts[1].base)
+    {
+        uartOutput(byte);
+    }
+}
+
+// TXBUF has become free: sets UCTXIFG, whose rising edge triggers the DMA
+static void uartTxReady(Uart *uart)
+{
+    REG16(uart->base + UART_IFG) |= UCTXIFG;
+    if (uart == &uarts[1])
+    {
+        dmaTrigger(DMA_TRIGGER_UCA1TX);
+    }
+}
+
+static void uartTransmit(Uart *uart, uint8_t byte)
+{
+    if (REG16(uart->base + UART_CTLW0) & UCSWRST)
+    {
+        return;
+    }
+
+    REG16(uart->base + UART_IFG) &= ~UCTXCPTIFG;
+    if (!uart->shifting)
+    {
+        // Goes straight into the shift register, TXBUF is free again
+        uartStartFrame(uart, byte);
+        uartTxReady(uart);
+    }
+    else
+    {
+        uart->bufferFull = 1;
+        uart->buffered = byte;
+        REG16(uart->base + UART_IFG) &= ~UCTXIFG;
+    }
+}
+
+static void uartAdvance(Uart *uart, uint32_t cycles)
+{
+    uint32_t clock = uartClock(uart);
+    uint32_t ticks;
+
+    if (!uart->shifting || !clock || !mclkHz)
+    {
+        return;
+    }
+
+    uart->phase += (uint64_t)cycles * clock;
+    ticks = (uint32_t)(uart->phase / mclkHz);
+    uart->phase %= mclkHz;
+
+    if (ticks < uart->frameLeft)
+    {
+        uart->frameLeft -= ticks;
+        return;
+    }
+
+    uart->shifting = 0;
+    if (uart->bufferFull)
+    {
+        uart->bufferFull = 0;
+        uartStartFrame(uart, uart->buffered);
+        uartTxReady(uart);
+    }
+    else
+    {
+        REG16(uart->base + UART_IFG) |= UCTXCPTIFG;
+    }
+}
+
+static uint16_t uartVector(const Uart *uart, uint8_t clear)
+{
+    uint16_t pending = REG16(uart->base + UART_IFG) & REG16(uart->base + UART_IE);
+    uint8_t bit;
+
+    for (bit = 0; bit < 4; bit++)
+    {
+        if (pending & (1 << bit))
+        {
+            if (clear)
+            {
+                REG16(uart->base + UART_IFG) &= ~(1 << bit);
+            }
+            return 2 * (bit + 1);
+        }
+    }
+    return 0;
+}
+
+static Uart *uartAt(uint32_t address)
+{
+    uint8_t i;
+
+    for (i = 0; i < UART_COUNT; i++)
+    {
+        if (address >= uarts[i].base && address < uarts[i].base + 0x20u)
+        {
+            return &uarts[i];
+        }
+    }
+    return 0;
+}
+
+void emuSetUartOutput(void (*output)(uint8_t byte))
+{
+    uartOutput = output;
+}
+
+/************************************************************
+* DMA
+************************************************************/
+
+static uint16_t dmaControlAddress(uint8_t channel)
+{
+    return DMA_BASE + DMA_CHANNEL0 + channel * 0x10 + DMA_CTL;
+}
+
+static uint32_t dmaRegisterAddress(uint8_t channel, uint8_t offset)
+{
+    uint16_t address = DMA_BASE + DMA_CHANNEL0 + channel * 0x10 + offset;
+
+    return (REG16(address) | ((uint32_t)REG16(address + 2) << 16)) & EMU_ADDRESS_MASK;
+}
+
+// Loads the addresses and size the channel starts from
+static void dmaLoad(uint8_t channel)
+{
+    DmaChannel *dma = &dmaChannels[channel];
+
+    dma->source = dmaRegisterAddress(channel, DMA_SA);
+    dma->destination = dmaRegisterAddress(channel, DMA_DA);
+    dma->left = REG16(DMA_BASE + DMA_CHANNEL0 + channel * 0x10 + DMA_SZ);
+}
+
+static uint32_t dmaStep(uint32_t address, uint16_t increment, uint8_t size)
+{
+    switch (increment)
+    {
+    case 2:  return (address - size) & EMU_ADDRESS_MASK;
+    case 3:  return (address + size) & EMU_ADDRESS_MASK;
+    default: return address;
+    }
+}
+
+// One transfer of a channel; the last one raises DMAIFG
+static void dmaTransfer(uint8_t channel)
+{
+    DmaChannel *dma = &dmaChannels[channel];
+    uint16_t address = dmaControlAddress(channel);
+    uint16_t control = REG16(address);
+    uint8_t sourceSize = (control & DMASRCBYTE) ? 1 : 2;
+    uint8_t destinationSize = (control & DMADSTBYTE) ? 1 : 2;
+    uint32_t destination = dma->destination;
+    uint16_t value;
+
+    if (!dma->left)
+    {
+        return;
+    }
+
+    if (dma->source < EMU_PERIPHERAL_END)
+    {
+        value = emuPeripheralRead(dma->source, sourceSize == 1);
+    }
+    else
+    {
+        value = sourceSize == 1 ? emuMemory[dma->source] : REG16(dma->source & ~1UL);
+    }
+    if (sourceSize == 1)
+    {
+        value &= 0x00FF;
+    }
+
+    dma->source = dmaStep(dma->source, (control & DMASRCINCR) >> 8, sourceSize);
+    dma->destination = dmaStep(destination, (control & DMADSTINCR) >> 10, destinationSize);
+    dma->left--;
+    dmaCycles += EMU_DMA_CYCLES;
+    if (!dma->left)
+    {
+        REG16(address) |= DMAIFG;
+        if (!(control & DMADT_REPEATED))
+        {
+            REG16(address) &= ~DMAEN;
+        }
+        dmaLoad(channel);
+    }
+
+    // Written last: a write to a peripheral may raise the next trigger
+    if (destination < EMU_PERIPHERAL_END)
+    {
+        emuPeripheralWrite(destination, value, destinationSize == 1);
+    }
+    else if (destinationSize == 1)
+    {
+        emuMemory[destination] = (uint8_t)value;
+    }
+    else
+    {
+        REG16(destination & ~1UL) = value;
+    }
+}
+
+// Runs one transfer on every enabled channel waiting for this trigger
+static void dmaTrigger(uint8_t trigger)
+{
+    uint8_t channel;
+
+    for (channel = 0; channel < DMA_CHANNEL_COUNT; channel++)
+    {
+        uint8_t select = REG8(DMA_BASE + DMA_CTL0 + channel);
+
+        if ((REG16(dmaControlAddress(channel)) & DMAEN) && select == trigger)
+        {
+            dmaTransfer(channel);
+        }
+    }
+}
+
+// Highest-priority channel with DMAIE and DMAIFG set, as a DMAIV value
+static uint16_t dmaVector(uint8_t clear)
+{
+    uint8_t channel;
+    uint16_t address;
+
+    for (channel = 0; channel < DMA_CHANNEL_COUNT; channel++)
+    {
+        address = dmaControlAddress(channel);
+        if ((REG16(address) & (DMAIE | DMAIFG)) == (DMAIE | DMAIFG))
+        {
+            if (clear)
+            {
+                REG16(address) &= ~DMAIFG;
+            }
+            return 2 * (channel + 1);
+        }
+    }
+    return 0;
+}
+
+static void dmaControlWritten(uint8_t channel, uint16_t before)
+{
+    uint16_t address = dmaControlAddress(channel);
+
+    if ((REG16(address) & DMAEN) && !(before & DMAEN))
+    {
+        dmaLoad(channel);
+    }
+    if (REG16(address) & DMAREQ)
+    {
+        REG16(address) &= ~DMAREQ;
+        if ((REG16(address) & DMAEN) && REG8(DMA_BASE + DMA_CTL0 + channel) == DMA_TRIGGER_DMAREQ)
+        {
+            dmaTransfer(channel);
+        }
+    }
+}
+
+uint32_t emuDmaCycles(void)
+{
+    return dmaCycles;
+}
+
+/************************************************************
+* MPY32
+************************************************************/
+
+static int64_t signExtend(uint64_t value, uint8_t bits)
+{
+    uint64_t sign = 1ULL << (bits - 1);
+
+    value &= (sign << 1) - 1;
+    return (int64_t)((value ^ sign) - sign);
+}
+
+// Operand 2 written: multiply, and accumulate for the MAC modes
+static void multiply(uint32_t operand2, uint8_t operand2Bits)
+{
+    uint8_t operand1Bits = (REG16(MPY_BASE + MPY_CTL0) & MPYOP1_32) ? 32 : 16;
+    uint8_t mode = mpyMode & 0x06;      // MPY, MPYS, MAC or MACS
+    uint8_t isSigned = (mode == MPY_MPYS || mode == MPY_MACS);
+    uint8_t wide = (operand1Bits == 32 || operand2Bits == 32);
+    uint64_t product;
+    uint64_t result;
+    uint64_t accumulator;
+    uint8_t carry = 0;
+
+    if (isSigned)
+    {
+        product = (uint64_t)(signExtend(mpyOperand1, operand1Bits)
+                             * signExtend(operand2, operand2Bits));
+    }
+    else
+    {
+        product = (uint64_t)(mpyOperand1 & (operand1Bits == 32 ? 0xFFFFFFFFUL : 0xFFFFUL))
+                  * (operand2 & (operand2Bits == 32 ? 0xFFFFFFFFUL : 0xFFFFUL));
+    }
+
+    result = product;
+    if (mode == MPY_MAC || mode == MPY_MACS)
+    {
+        accumulator = (uint64_t)REG16(MPY_BASE + MPY_RES0)
+                      | ((uint64_t)REG16(MPY_BASE + MPY_RES0 + 2) << 16)
+                      | ((uint64_t)REG16(MPY_BASE + MPY_RES0 + 4) << 32)
+                      | ((uint64_t)REG16(MPY_BASE + MPY_RES0 + 6) << 48);
+        if (!wide)
+        {
+            accumulator &= 0xFFFFFFFFULL;
+            product &= 0xFFFFFFFFULL;
+            carry = (accumulator + product) > 0xFFFFFFFFULL;
+        }
+        else
+        {
+            carry = (accumulator + product) < accumulator;
+        }
+        result = accumulator + product;
+    }
+
+    REG16(MPY_BASE + MPY_RES0) = (uint16_t)result;
+    REG16(MPY_BASE + MPY_RES0 + 2) = (uint16_t)(result >> 16);
+    REG16(MPY_BASE + MPY_RES0 + 4) = (uint16_t)(result >> 32);
+    REG16(MPY_BASE + MPY_RES0 + 6) = (uint16_t)(result >> 48);
+    REG16(MPY_BASE + MPY_RESLO) = (uint16_t)result;
+    REG16(MPY_BASE + MPY_RESHI) = (uint16_t)(result >> 16);
+
+    // SUMEXT holds the sign of a signed result or the carry of an unsigned sum
+    if (isSigned)
+    {
+        REG16(MPY_BASE + MPY_SUMEXT) = ((wide ? result >> 63 : result >> 31) & 1) ? 0xFFFF : 0;
+    }
+    else
+    {
+        REG16(MPY_BASE + MPY_SUMEXT) = carry;
+    }
+    if (carry)
+    {
+        REG16(MPY_BASE + MPY_CTL0) |= MPYC;
+    }
+    else
+    {
+        REG16(MPY_BASE + MPY_CTL0) &= ~MPYC;
+    }
+}
+
+static void multiplierWritten(uint16_t offset, uint8_t isByte)
+{
+    uint16_t value = REG16(MPY_BASE + (offset & ~1));
+
+    if (offset < MPY_OP2)
+    {
+        // 16-bit operand 1; byte writes are sign extended in the signed modes
+        mpyMode = offset & 0x06;
+        mpyOperand1 = value;
+        if (isByte)
+        {
+            mpyOperand1 = (mpyMode == MPY_MPYS || mpyMode == MPY_MACS)
+                          ? (uint16_t)(int16_t)(int8_t)value : (value & 0xFF);
+        }
+        REG16(MPY_BASE + MPY_CTL0) &= ~MPYOP1_32;
+    }
+    else if (offset == MPY_OP2)
+    {
+        if (isByte)
+        {
+            value = (mpyMode == MPY_MPYS || mpyMode == MPY_MACS)
+                    ? (uint16_t)(int16_t)(int8_t)value : (value & 0xFF);
+        }
+        REG16(MPY_BASE + MPY_CTL0) &= ~MPYOP2_32;
+        multiply(value, 16);
+    }
+    else if (offset >= MPY_MPY32L && offset <= MPY_MACS32H + 1)
+    {
+        // 32-bit operand 1: low word first, then the high word
+        mpyMode = ((offset - MPY_MPY32L) >> 1) & 0x06;
+        if (((offset - MPY_MPY32L) >> 1) & 1)
+        {
+            mpyOperand1 = (mpyOperand1 & 0xFFFF) | ((uint32_t)value << 16);
+        }
+        else
+        {
+            mpyOperand1 = value;
+        }
+        REG16(MPY_BASE + MPY_CTL0) |= MPYOP1_32;
+    }
+    else if (offset == MPY_OP2H || offset == MPY_OP2H + 1)
+    {
+        REG16(MPY_BASE + MPY_CTL0) |= MPYOP2_32;
+        multiply(REG16(MPY_BASE + MPY_OP2L) | ((uint32_t)value << 16), 32);
+    }
+    else if ((offset & ~1) == MPY_RESLO || (offset & ~1) == MPY_RESHI)
+    {
+        // Preloading the accumulator, RESLO/RESHI are RES0/RES1
+        REG16(MPY_BASE + MPY_RES0 + (offset & ~1) - MPY_RESLO) = value;
+    }
+    else if ((offset & ~1) == MPY_RES0 || (offset & ~1) == MPY_RES0 + 2)
+    {
+        REG16(MPY_BASE + MPY_RESLO + (offset & ~1) - MPY_RES0) = value;
+    }
+}
+
+/************************************************************
+* CRC16
+************************************************************/
+
+// Shifts 'bits' bits of data into the CRC, LSB first or MSB first, and
+// updates both result registers
+static void crcShift(uint16_t data, uint8_t bits, uint8_t lsbFirst)
+{
+    uint16_t crc = REG16(CRCINIRES);
+    uint16_t reversed = 0;
+    uint8_t in;
+    uint8_t i;
+
+    for (i = 0; i < bits; i++)
+    {
+        in = lsbFirst ? (data >> i) & 1 : (data >> (bits - 1 - i)) & 1;
+        crc = ((crc >> 15) ^ in) ? (crc << 1) ^ CRC_POLYNOMIAL : crc << 1;
+    }
+    for (i = 0; i < 16; i++)
+    {
+        reversed |= ((crc >> i) & 1) << (15 - i);
+    }
+
+    REG16(CRCINIRES) = crc;
+    REG16(CRCRESR) = reversed;
+}
+
+/************************************************************
+* BUS
+************************************************************/
+
+uint16_t emuPeripheralRead(uint32_t address, uint8_t isByte)
+{
+    uint16_t word = (uint16_t)(address & ~1UL);
+    Timer *timer;
+    Uart *uart;
+
+    if (word == P1IN)
+    {
+        REG8(P1IN) = portOneLevel();
+    }
+    else if (word == P1IV)
+    {
+        REG16(P1IV) = portOneVector(1);
+    }
+    else if (word == WDTCTL)
+    {
+        REG8(WDTCTL + 1) = 0x69;
+    }
+    else if ((timer = timerAt(word)) != 0 && word == timer->base + TIMER_IV)
+    {
+        REG16(word) = timerVector(timer, 1);
+    }
+    else if (word == DMA_BASE + DMA_IV)
+    {
+        REG16(word) = dmaVector(1);
+    }
+    else if ((uart = uartAt(word)) != 0)
+    {
+        if (word == uart->base + UART_IV)
+        {
+            REG16(word) = uartVector(uart, 1);
+        }
+        else if (word == uart->base + UART_RXBUF)
+        {
+            REG16(uart->base + UART_IFG) &= ~UCRXIFG;
+        }
+    }
+
+    return isByte ? REG8(address) : REG16(word);
+}
+
+void emuPeripheralWrite(uint32_t address, uint16_t value, uint8_t isByte)
+{
+    uint16_t word = (uint16_t)(address & ~1UL);
+    uint16_t before = REG16(word);
+    Timer *timer;
+    Uart *uart;
+    uint8_t i;
+
+    if (isByte)
+    {
+        REG8(address) = (uint8_t)value;
+    }
+    else
+    {
+        REG16(word) = value;
+    }
+
+    if (word == P1IN)
+    {
+        REG16(word) = before;
+    }
+    else if (word == P1IV)
+    {
+        REG8(P1IFG) = 0;
+    }
+    else if (word >= CSCTL1 && word <= CSCTL5)
+    {
+        updateCrystal();
+        updateClocks();
+    }
+    else if (word == CRCDI || word == CRCDIRB)
+    {
+        crcShift(value, isByte ? 8 : 16, word == CRCDI);
+    }
+    else if (word == LCDCMEMCTL)
+    {
+        for (i = 0; i < LCD_MEMORY_SIZE; i++)
+        {
+            if (REG16(LCDCMEMCTL) & LCDCLRM)
+            {
+                REG8(LCDM1 + i) = 0;
+            }
+            if (REG16(LCDCMEMCTL) & LCDCLRBM)
+            {
+                REG8(LCDBM1 + i) = 0;
+            }
+        }
+        REG16(LCDCMEMCTL) &= ~(LCDCLRM | LCDCLRBM);
+        checkFirstFrame();
+    }
+    else if (word == LCDCCTL0 || (word >= LCDM1 && word < LCDBM1 + LCD_MEMORY_SIZE))
+    {
+        checkFirstFrame();
+    }
+    else if (word >= MPY_BASE && word < MPY_BASE + MPY_CTL0)
+    {
+        multiplierWritten(address - MPY_BASE, isByte);
+    }
+    else if (word >= DMA_BASE + DMA_CHANNEL0 && word < DMA_BASE + DMA_CHANNEL0 + DMA_CHANNEL_COUNT * 0x10
+             && (word & 0x0F) == DMA_CTL)
+    {
+        dmaControlWritten((word - DMA_BASE - DMA_CHANNEL0) / 0x10, before);
+    }
+    else if ((timer = timerAt(word)) != 0)
+    {
+        uint16_t offset = word - timer->base;
+
+        if (offset == TIMER_CTL && (REG16(word) & TIMER_CLR))
+        {
+            REG16(timer->base + TIMER_R) = 0;
+            REG16(word) &= ~TIMER_CLR;
+            timer->countingDown = 0;
+            timer->phase = 0;
+        }
+        else if (offset >= TIMER_CCTL0 && offset < TIMER_CCTL0 + 2 * timer->ccrCount)
+        {
+            timerControlWritten(timer, (offset - TIMER_CCTL0) / 2, before);
+        }
+        else if (offset == TIMER_IV)
+        {
+            timerVector(timer, 1);
+        }
+    }
+    else if ((uart = uartAt(word)) != 0)
+    {
+        uint16_t offset = word - uart->base;
+
+        if (offset == UART_CTLW0 && (REG16(word) & UCSWRST))
+        {
+            REG16(uart->base + UART_IFG) = UCTXIFG;
+            REG16(uart->base + UART_IE) = 0;
+            uart->shifting = 0;
+            uart->bufferFull = 0;
+        }
+        else if (offset == UART_TXBUF)
+        {
+            uartTransmit(uart, (uint8_t)value);
+        }
+    }
+}
+
+/************************************************************
+* TIME AND INTERRUPTS
+************************************************************/
+
+void emuPeripheralsAdvance(uint32_t cycles, uint16_t sr)
+{
+    uint8_t i;
+
+    if (!mclkHz)
+    {
+        return;
+    }
+
+    timePs += (uint64_t)cycles * 1000000000000ULL / mclkHz;
+
+    for (i = 0; i < TIMER_COUNT; i++)
+    {
+        timerAdvance(&timers[i], cycles, sr);
+    }
+    for (i = 0; i < UART_COUNT; i++)
+    {
+        uartAdvance(&uarts[i], cycles);
+    }
+    if (!lfxtRunning)
+    {
+        updateCrystal();
+    }
+}
+
+uint32_t emuSleepStep(uint16_t sr)
+{
+    uint32_t fastest = 1000;    // Look at the buttons at least every 1 ms
+    uint32_t clock;
+    uint8_t i;
+
+    for (i = 0; i < TIMER_COUNT; i++)
+    {
+        clock = timerClock(&timers[i], sr) / timerDivider(&timers[i]);
+        if (clock > fastest)
+        {
+            fastest = clock;
+        }
+    }
+    for (i = 0; i < UART_COUNT; i++)
+    {
+        clock = uartClock(&uarts[i]) / 16;
+        if (uarts[i].shifting && clock > fastest)
+        {
+            fastest = clock;
+        }
+    }
+
+    return (mclkHz + fastest - 1) / fastest;
+}
+
+uint16_t emuPendingInterrupt(void)
+{
+    uint16_t vector = 0;
+    uint8_t i;
+
+    for (i = 0; i < TIMER_COUNT; i++)
+    {
+        const Timer *timer = &timers[i];
+        uint16_t control = REG16(timer->base + TIMER_CCTL0);
+
+        if ((control & (CC_IFG | CC_IE)) == (CC_IFG | CC_IE) && timer->vector0 > vector)
+        {
+            vector = timer->vector0;
+        }
+        if (timer->vector1 > vector && timerVector(timer, 0))
+        {
+            vector = timer->vector1;
+        }
+    }
+    for (i = 0; i < UART_COUNT; i++)
+    {
+        if (uarts[i].vector > vector && uartVector(&uarts[i], 0))
+        {
+            vector = uarts[i].vector;
+        }
+    }
+    if (DMA_VECTOR > vector && dmaVector(0))
+    {
+        vector = DMA_VECTOR;
+    }
+    if (PORT1_VECTOR > vector && portOneVector(0))
+    {
+        vector = PORT1_VECTOR;
+    }
+
+    return vector;
+}
+
+void emuAcknowledgeInterrupt(uint16_t vector)
+{
+    uint8_t i;
+
+    // CCR0 is the only source of its vector, so its flag clears on entry
+    for (i = 0; i < TIMER_COUNT; i++)
+    {
+        if (vector == timers[i].vector0)
+        {
+            REG16(timers[i].base + TIMER_CCTL0) &= ~CC_IFG;
+        }
+    }
+}
+
+void emuPeripheralsReset(void)
+{
+    uint8_t i;
+
+    for (i = 0; i < TIMER_COUNT; i++)
+    {
+        timers[i].countingDown = 0;
+        timers[i].phase = 0;
+    }
+    for (i = 0; i < UART_COUNT; i++)
+    {
+        uarts[i].shifting = 0;
+        uarts[i].bufferFull = 0;
+        uarts[i].phase = 0;
+        REG16(uarts[i].base + UART_CTLW0) = UCSWRST;
+        REG16(uarts[i].base + UART_IFG) = UCTXIFG;
+    }
+    for (i = 0; i < DMA_CHANNEL_COUNT; i++)
+    {
+        dmaChannels[i].left = 0;
+        REG16(dmaControlAddress(i)) = 0;
+    }
+    dmaCycles = 0;
+    firstFramePs = 0;
+    framesShown = 0;
+
+    // Power-up values: 8 MHz DCO divided by 8 for MCLK and SMCLK, ACLK
+    // asking for the crystal, pins locked until LOCKLPM5 is cleared
+    REG16(CSCTL1) = 0x000C;
+    REG16(CSCTL2) = 0x0033;
+    REG16(CSCTL3) = 0x0033;
+    REG16(CSCTL4) = LFXTOFF | HFXTOFF;
+    REG16(PM5CTL0) = LOCKLPM5;
+    REG16(WDTCTL) = 0x6904;
+
+    timePs = 0;
+    lfxtRequested = 0;
+    lfxtRunning = 0;
+    buttonsHeld = 0;
+    updateCrystal();
+    updateClocks();
+}
+
+#endif
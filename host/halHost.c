@@ -0,0 +1,462 @@
+/******************************************************************************
+ *
+ * FILE: host/halHost.c
+ *
+ * DESCRIPTION:
+ *   Behaviour of the Linux register model.
+ *   - The simulated address space behind every register in host/msp430.h.
+ *   - Low-power sleeps: instead of waiting, time jumps straight to the next
+ *     10 ms Timer_A1 tick and the tick ISR is called, until an ISR asks to
+ *     leave the low-power mode.
+ *   - Code runs in no time, so Timer_A0 (the CPU-active time counter)
+ *     never counts; the active time of each game phase is measured on
+ *     the instruction-set emulator instead (host/emuGame.c).
+ *   - Buttons: at every tick the input function says which buttons are
+ *     held, P1IN is updated and edges set P1IFG just like the real port.
+ *   - UART: bytes written to UCA1TXBUF are captured, and the transmitter is
+ *     always ready, so an enabled transmit interrupt runs until it turns
+ *     itself off.
+ *   - DMA: channel 0 triggered by UCA1TXIFG moves its whole block into
+ *     UCA1TXBUF at once, then raises DMAIFG for the DMA ISR.
+ *   - Timer_B0: counts ACLK in continuous mode with its overflow interrupt,
+ *     and CCR1/CCR2 latch TB0R on software captures made by an ISR.
+ *   - LFXT: the crystal starts HAL_HOST_LFXT_START_MS after it is enabled.
+ *     Until then its fault flags are set again at every tick, and ACLK
+ *     taken from it runs at LFMODCLK.
+ *
+ * CREATED BY:
+ *   Hanna Szalai & Haroun Riahi
+ *
+ ******************************************************************************/
+
+#ifdef HAL_HOST
+
+#include <msp430.h>
+#include <setjmp.h>
+#include <string.h>
+#include "halHost.h"
+
+#define BUTTON_PINS     (BIT1 | BIT2)
+#define UART_LOG_SIZE   256
+
+// DMA trigger number of UCA1TXIFG
+#define DMA_TRIGGER_UCA1TX  17
+
+// First DMA address of host memory outside halHostMemory
+#define DMA_WINDOW          0x10000UL
+
+volatile uint8_t halHostMemory[0x10000];
+
+// Firmware entry point and interrupt service routines
+void firmwareMain(void);
+void Timer_A1(void);
+void Port_1(void);
+void USCI_A1_ISR(void);
+void DMA_ISR(void);
+void Timer0_B1(void);
+
+// From host/driverlibHost.c
+uint32_t CS_getACLK(void);
+
+static HalHostInput inputFunction = 0;
+static uint32_t timeMs = 0;
+static uint64_t timerBMilliCounts = 0;  // Timer_B0 counts times 1000
+static uint8_t  crystalEnabled = 0;
+static uint32_t crystalEnabledMs = 0;
+static uint8_t interruptsEnabled = 0;
+static uint8_t inInterrupt = 0;
+static uint8_t wokenUp = 0;
+
+static jmp_buf stopPoint;
+static int stopCode = 0;
+
+static volatile uint16_t uartTxSlot;
+static uint8_t uartTxPending = 0;
+static char uartLog[UART_LOG_SIZE];
+static char uartTail[UART_LOG_SIZE + 1];
+static uint32_t uartCount = 0;
+
+static const volatile void *dmaWindow = 0;
+
+static uint16_t captureInputs[2];
+static void (*uartOutput)(uint8_t byte) = 0;
+
+// Stores the byte the firmware wrote into the last transmit slot
+static void commitUartByte(void)
+{
+    if (uartTxPending)
+    {
+        uartLog[uartCount % UART_LOG_SIZE] = (char)uartTxSlot;
+        uartCount++;
+        uartTxPending = 0;
+        if (uartOutput)
+        {
+            uartOutput((uint8_t)uartTxSlot);
+        }
+    }
+}
+
+volatile uint16_t *halHostUartTxSlot(void)
+{
+    commitUartByte();
+    uartTxPending = 1;
+    return &uartTxSlot;
+}
+
+// DMA address of a byte (DMA_ADDRESS in host/msp430.h). Registers are
+// their offset in halHostMemory, like everywhere else in the model. Any
+// other host memory, static or on the stack, is reached through a window
+// at DMA_WINDOW that starts at the pointer given last.
+uint32_t halHostDmaAddress(const volatile void *pointer)
+{
+    uintptr_t address = (uintptr_t)pointer;
+    uintptr_t memory = (uintptr_t)halHostMemory;
+
+    if (address >= memory && address < memory + sizeof(halHostMemory))
+    {
+        return (uint32_t)(address - memory);
+    }
+    dmaWindow = pointer;
+    return DMA_WINDOW;
+}
+
+// Host pointer to the source of DMA channel 0
+static const volatile uint8_t *dmaSource(void)
+{
+    uint32_t address = ((uint32_t)DMA0SAH << 16) | DMA0SAL;
+
+    if (address < DMA_WINDOW)
+    {
+        return &halHostMemory[address];
+    }
+    return (const volatile uint8_t *)dmaWindow + (address - DMA_WINDOW);
+}
+
+// Runs DMA channel 0 when it is enabled with the UART trigger. TXBUF is
+// always ready on the host, so the whole block goes at once.
+static void runDma(void)
+{
+    const volatile uint8_t *source;
+    uint16_t left;
+
+    if (!(DMA0CTL & DMAEN) || (DMACTL0 & 0xFF) != DMA_TRIGGER_UCA1TX)
+    {
+        return;
+    }
+
+    source = dmaSource();
+    for (left = DMA0SZ; left; left--)
+    {
+        UCA1TXBUF = *source;
+        if (DMA0CTL & DMASRCINCR_3)
+        {
+            source++;
+        }
+    }
+    DMA0CTL = (DMA0CTL & ~DMAEN) | DMAIFG;
+}
+
+// Software captures of Timer_B0 CCR1/CCR2: switching a capture input
+// between GND and VCC latches TB0R, like on the chip
+static void captureTimerB(void)
+{
+    volatile uint16_t *controls = &TB0CCTL1;
+    volatile uint16_t *registers = &TB0CCR1;
+    uint16_t input;
+    uint8_t n;
+
+    for (n = 0; n < 2; n++)
+    {
+        input = controls[n] & CCIS_3;
+        if ((controls[n] & CAP) && input >= CCIS_2 && captureInputs[n] >= CCIS_2
+            && input != captureInputs[n])
+        {
+            registers[n] = TB0R;
+            controls[n] |= CCIFG;
+        }
+        captureInputs[n] = input;
+    }
+}
+
+// Runs every ISR whose enable and flag bits are both set
+static void serviceInterrupts(void)
+{
+    if (!interruptsEnabled || inInterrupt)
+    {
+        return;
+    }
+
+    inInterrupt = 1;
+    while (P1IE & P1IFG)
+    {
+        Port_1();
+        captureTimerB();
+    }
+    for (;;)
+    {
+        runDma();
+        if ((UCA1IE & UCTXIE) && (UCA1IFG & UCTXIFG))
+        {
+            USCI_A1_ISR();
+        }
+        else if ((DMA0CTL & (DMAIE | DMAIFG)) == (DMAIE | DMAIFG))
+        {
+            DMA_ISR();
+        }
+        else
+        {
+            break;
+        }
+    }
+    inInterrupt = 0;
+}
+
+// Keeps the crystal fault flags set until the crystal has started
+static void updateCrystal(void)
+{
+    if (CSCTL4 & LFXTOFF)
+    {
+        crystalEnabled = 0;
+        return;
+    }
+    if (!crystalEnabled)
+    {
+        crystalEnabled = 1;
+        crystalEnabledMs = timeMs;
+    }
+    if (timeMs - crystalEnabledMs < HAL_HOST_LFXT_START_MS)
+    {
+        CSCTL5 |= LFXTOFFG;
+        SFRIFG1 |= OFIFG;
+    }
+}
+
+// Moves simulated time forward by one Timer_A1 tick
+static void advanceTick(void)
+{
+    uint8_t held;
+    uint8_t oldLevel;
+    uint8_t newLevel;
+    uint8_t changed;
+
+    timeMs += HAL_HOST_TICK_MS;
+    updateCrystal();
+
+    // Timer_B0 counts ACLK in continuous mode; its overflow interrupt
+    // extends it
+    if (TB0CTL & (MC0 | MC1))
+    {
+        uint16_t before = TB0R;
+
+        timerBMilliCounts += (uint64_t)HAL_HOST_TICK_MS * CS_getACLK();
+        TB0R = (uint16_t)(timerBMilliCounts / 1000);
+        if (TB0R < before)
+        {
+            TB0CTL |= TBIFG;
+        }
+        if ((TB0CTL & (TBIE | TBIFG)) == (TBIE | TBIFG) && interruptsEnabled)
+        {
+            inInterrupt = 1;
+            Timer0_B1();
+            inInterrupt = 0;
+        }
+    }
+
+    // Buttons pull the pin low while held
+    held = inputFunction ? inputFunction(timeMs) : 0;
+    oldLevel = P1IN;
+    newLevel = (oldLevel & ~BUTTON_PINS) | (~held & BUTTON_PINS);
+    changed = oldLevel ^ newLevel;
+
+    // P1IES set means the flag is raised on a high-to-low edge
+    P1IFG |= (changed & oldLevel & P1IES) | (changed & newLevel & ~P1IES);
+    P1IN = newLevel;
+    serviceInterrupts();
+
+    // Timer_A1 CCR0 interrupt, once per tick while the timer runs
+    if ((TA1CTL & (MC0 | MC1)) && (TA1CCTL0 & CCIE) && interruptsEnabled)
+    {
+        inInterrupt = 1;
+        Timer_A1();
+        captureTimerB();
+        inInterrupt = 0;
+    }
+}
+
+void halHostSetSR(uint16_t bits)
+{
+    // An interrupt that is already pending may end the sleep right away
+    if (bits & CPUOFF)
+    {
+        wokenUp = 0;
+    }
+
+    if (bits & GIE)
+    {
+        interruptsEnabled = 1;
+        serviceInterrupts();
+    }
+
+    if (bits & CPUOFF)
+    {
+        // Sleep until an ISR clears the low-power bits on exit
+        while (!wokenUp)
+        {
+            advanceTick();
+        }
+    }
+}
+
+void halHostClearSROnExit(uint16_t bits)
+{
+    if (bits & CPUOFF)
+    {
+        wokenUp = 1;
+    }
+}
+
+void halHostDisableInterrupts(void)
+{
+    interruptsEnabled = 0;
+}
+
+// The SR as __get_interrupt_state returns it: only GIE is modelled
+uint16_t halHostGetInterruptState(void)
+{
+    return interruptsEnabled ? GIE : 0;
+}
+
+void halHostSetInterruptState(uint16_t state)
+{
+    if (state & GIE)
+    {
+        halHostSetSR(GIE);
+    }
+    else
+    {
+        halHostDisableInterrupts();
+    }
+}
+
+// Decimal add of eight BCD digits, as two DADD instructions do it
+uint32_t halHostBcdAddLong(uint32_t a, uint32_t b)
+{
+    uint32_t sum = 0;
+    uint8_t carry = 0;
+    uint8_t digit;
+    int i;
+
+    for (i = 0; i < 32; i += 4)
+    {
+        digit = ((a >> i) & 0xF) + ((b >> i) & 0xF) + carry;
+        carry = digit > 9;
+        if (carry)
+        {
+            digit -= 10;
+        }
+        sum |= (uint32_t)(digit & 0xF) << i;
+    }
+    return sum;
+}
+
+void halHostReset(void)
+{
+    memset((void *)halHostMemory, 0, sizeof(halHostMemory));
+
+    // Buttons have pull-ups, so both read high
+    P1IN = 0xFF;
+    PM5CTL0 = LOCKLPM5;
+    UCA1IFG = UCTXIFG;
+
+    // Clock system reset values: 1 MHz DCO, MCLK and SMCLK divided by 8
+    CSCTL1 = DCOFSEL_0;
+    CSCTL2 = SELA__LFXTCLK | SELS__DCOCLK | SELM__DCOCLK;
+    CSCTL3 = DIVA__1 | DIVS__8 | DIVM__8;
+    CSCTL4 = LFXTOFF;
+
+    timeMs = 0;
+    timerBMilliCounts = 0;
+    crystalEnabled = 0;
+    interruptsEnabled = 0;
+    inInterrupt = 0;
+    uartTxPending = 0;
+    uartCount = 0;
+    captureInputs[0] = 0;
+    captureInputs[1] = 0;
+}
+
+void halHostSetInput(HalHostInput input)
+{
+    inputFunction = input;
+}
+
+int halHostRun(void)
+{
+    if (setjmp(stopPoint) == 0)
+    {
+        firmwareMain();
+    }
+
+    return stopCode;
+}
+
+void halHostStop(int code)
+{
+    stopCode = code;
+    longjmp(stopPoint, 1);
+}
+
+uint32_t halHostTimeMs(void)
+{
+    return timeMs;
+}
+
+uint8_t halHostLeds(void)
+{
+    uint8_t leds = 0;
+
+    if (P1DIR & P1OUT & BIT0)
+    {
+        leds |= HAL_HOST_LED_RED;
+    }
+    if (P9DIR & P9OUT & BIT7)
+    {
+        leds |= HAL_HOST_LED_GREEN;
+    }
+
+    return leds;
+}
+
+uint8_t halHostLcdMemory(uint8_t index)
+{
+    return (LCDCMEMCTL & LCDDISP) ? LCDBMEM[index - 1] : LCDMEM[index - 1];
+}
+
+uint32_t halHostUartCount(void)
+{
+    commitUartByte();
+    return uartCount;
+}
+
+void halHostSetUartOutput(void (*output)(uint8_t byte))
+{
+    uartOutput = output;
+}
+
+const char *halHostUartTail(void)
+{
+    uint32_t start;
+    uint32_t i;
+
+    commitUartByte();
+    start = uartCount > UART_LOG_SIZE ? uartCount - UART_LOG_SIZE : 0;
+    for (i = start; i < uartCount; i++)
+    {
+        uartTail[i - start] = uartLog[i % UART_LOG_SIZE];
+    }
+    uartTail[uartCount - start] = '\0';
+
+    return uartTail;
+}
+
+#endif
@@ -0,0 +1,67 @@
+/******************************************************************************
+ *
+ * FILE: host/halHost.h
+ *
+ * PURPOSE:
+ *   Declares the control interface of the Linux register model. A host
+ *   program uses it to feed scripted button input to the game, advance
+ *   simulated time and look at the LEDs, LCD and UART output.
+ *
+ *   Time only moves forward while the firmware sleeps in a low-power mode:
+ *   each sleep jumps straight to the next 10 ms timer tick, so thousands of
+ *   games can be played per second.
+ *
+ * CREATED BY:
+ *   Hanna Szalai & Haroun Riahi
+ *
+ ******************************************************************************/
+
+#ifndef HOST_HALHOST_H_
+#define HOST_HALHOST_H_
+
+#include <stdint.h>
+
+// Simulated time between two Timer_A1 ticks
+#define HAL_HOST_TICK_MS        10
+
+// Time the 32768 Hz crystal takes to start once it is enabled
+#define HAL_HOST_LFXT_START_MS  250
+
+// LED bits returned by halHostLeds()
+#define HAL_HOST_LED_RED        0x01
+#define HAL_HOST_LED_GREEN      0x02
+
+// Called once per simulated tick; returns the mask of buttons held down
+// (BIT1 for S1, BIT2 for S2)
+typedef uint8_t (*HalHostInput)(uint32_t timeMs);
+
+// Puts every register back to its power-up value
+void halHostReset(void);
+
+// Sets the function that decides which buttons are held at each tick
+void halHostSetInput(HalHostInput input);
+
+// Runs the firmware until halHostStop() is called; returns the stop code
+int halHostRun(void);
+
+// Ends halHostRun() from inside the input function
+void halHostStop(int code);
+
+// Simulated time since the last reset
+uint32_t halHostTimeMs(void);
+
+// Which LEDs are lit right now
+uint8_t halHostLeds(void);
+
+// Raw segment bytes of an LCD memory location (1-based, like LCDMx) in the
+// bank on display (LCDMEM, or LCDBMEM when LCDDISP is set)
+uint8_t halHostLcdMemory(uint8_t index);
+
+// Number of UART bytes sent and the last bytes themselves
+uint32_t halHostUartCount(void);
+const char *halHostUartTail(void);
+
+// Also hands every UART byte to output as it is sent (0 to stop)
+void halHostSetUartOutput(void (*output)(uint8_t byte));
+
+#endif
@@ -0,0 +1,141 @@
+/******************************************************************************
+ *
+ * FILE: host/messageGen.c
+ *
+ * DESCRIPTION:
+ *   Writes messages.c: every text of LCD_MESSAGES (messages.h) encoded
+ *   with the glyph table of lcdGlyphs.h, the same one lcdDisplay.c is
+ *   built with, as const segment bytes with LCD_NUM_CHAR blank cells on
+ *   both sides. Each cell is commented with its character so the output
+ *   can be checked by eye and diffed.
+ *
+ * BUILD AND RUN (from the repository root):
+ *   gcc -O2 -DHAL_HOST -Ihost -I. host/messageGen.c -o messageGen
+ *   ./messageGen > messages.c
+ *
+ * CREATED BY:
+ *   Hanna Szalai & Haroun Riahi
+ *
+ ******************************************************************************/
+
+#ifdef HAL_HOST
+
+#define HAL_HOST_PROGRAM
+
+#include <stdio.h>
+#include <string.h>
+#include <lcdDisplay.h>
+#include "lcdGlyphs.h"
+#include "messages.h"
+
+typedef struct
+{
+    const char *name;
+    const char *text;
+} MessageText;
+
+#define MESSAGE_TEXT( id, text )    { #id, text },
+
+static const MessageText texts[MSG_COUNT] =
+{
+    LCD_MESSAGES( MESSAGE_TEXT )
+};
+
+static const char glyphs[LCD_GLYPH_COUNT][2] =
+{
+    LCD_GLYPH_TABLE
+};
+
+// "MSG_GAME_OVER" -> "cellsGameOver"
+static void printArrayName(const char *id)
+{
+    int upper = 1;
+
+    printf("cells");
+    for (id += strlen("MSG_"); *id; id++)
+    {
+        if (*id == '_')
+        {
+            upper = 1;
+            continue;
+        }
+        putchar(upper ? *id : (*id >= 'A' && *id <= 'Z' ? *id - 'A' + 'a' : *id));
+        upper = 0;
+    }
+}
+
+static void printCell(unsigned char c, int last)
+{
+    const char *glyph = glyphs[LCD_GLYPH_INDEX(c)];
+
+    printf("    { 0x%02X, 0x%02X }%s", (unsigned char)glyph[0], (unsigned char)glyph[1],
+           last ? " " : ",");
+    if (c >= ' ' && c < 0x7F && c != '\\')
+    {
+        printf("  /* '%c' */", c);
+    }
+    printf("\n");
+}
+
+static void printMessage(const MessageText *message)
+{
+    size_t length = strlen(message->text);
+    size_t i;
+
+    printf("// \"%s\"\n", message->text);
+    printf("static const char ");
+    printArrayName(message->name);
+    printf("[%u][2] =\n{\n", (unsigned)(length + 2 * LCD_NUM_CHAR));
+    for (i = 0; i < LCD_NUM_CHAR; i++)
+    {
+        printCell(' ', 0);
+    }
+    for (i = 0; i < length; i++)
+    {
+        printCell((unsigned char)message->text[i], 0);
+    }
+    for (i = 0; i < LCD_NUM_CHAR; i++)
+    {
+        printCell(' ', i == LCD_NUM_CHAR - 1);
+    }
+    printf("};\n\n");
+}
+
+int main(void)
+{
+    int i;
+
+    printf("/******************************************************************************\n"
+           " *\n"
+           " * FILE: messages.c\n"
+           " *\n"
+           " * DESCRIPTION:\n"
+           " *   The texts of messages.h as LCD segment bytes.\n"
+           " *   Generated by host/messageGen.c from messages.h and lcdGlyphs.h;\n"
+           " *   do not edit, regenerate it instead.\n"
+           " *\n"
+           " * CREATED BY:\n"
+           " *   Hanna Szalai & Haroun Riahi\n"
+           " *\n"
+           " ******************************************************************************/\n"
+           "\n"
+           "#include \"messages.h\"\n"
+           "\n");
+
+    for (i = 0; i < MSG_COUNT; i++)
+    {
+        printMessage(&texts[i]);
+    }
+
+    printf("const Message messages[MSG_COUNT] =\n{\n");
+    for (i = 0; i < MSG_COUNT; i++)
+    {
+        printf("    { ");
+        printArrayName(texts[i].name);
+        printf(", %u }%s\n", (unsigned)strlen(texts[i].text), i == MSG_COUNT - 1 ? "" : ",");
+    }
+    printf("};\n");
+    return 0;
+}
+
+#endif
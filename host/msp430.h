@@ -0,0 +1,504 @@
+/******************************************************************************
+ *
+ * FILE: host/msp430.h
+ *
+ * PURPOSE:
+ *   Register model of the MSP430FR6989 for building the game on Linux.
+ *   This header stands in for TI's <msp430.h> when the host folder is put
+ *   first on the include path. Every register the game and DriverLib
+ *   touch is mapped into a simulated 64 KB address space at its real
+ *   address, so code written for the board runs unchanged.
+ *
+ *   Only the registers, bits and intrinsics the game uses are modelled.
+ *   The behaviour behind them (timers, buttons, UART, LCD) is in halHost.c.
+ *
+ * CREATED BY:
+ *   Hanna Szalai & Haroun Riahi
+ *
+ ******************************************************************************/
+
+#ifndef HOST_MSP430_H_
+#define HOST_MSP430_H_
+
+#include <stdint.h>
+
+// Simulated address space holding all peripheral registers and LCD memory
+extern volatile uint8_t halHostMemory[0x10000];
+
+#define SFR_8BIT(addr)      (*(volatile uint8_t  *)&halHostMemory[(addr)])
+#define SFR_16BIT(addr)     (*(volatile uint16_t *)&halHostMemory[(addr)])
+
+// The firmware entry point is called by the simulator, not by the C runtime.
+// Host programs that have their own main() define HAL_HOST_PROGRAM first.
+#ifndef HAL_HOST_PROGRAM
+#define main                firmwareMain
+#endif
+
+/************************************************************
+* INTRINSICS
+************************************************************/
+
+void     halHostSetSR(uint16_t bits);
+void     halHostClearSROnExit(uint16_t bits);
+
+#define __interrupt
+#define __disable_interrupt()           halHostDisableInterrupts()
+#define __enable_interrupt()            halHostSetSR(GIE)
+#define __bis_SR_register(bits)         halHostSetSR(bits)
+#define __bic_SR_register_on_exit(bits) halHostClearSROnExit(bits)
+#define _BIS_SR(bits)                   halHostSetSR(bits)
+#define __no_operation()
+#define __bcd_add_long(a, b)            halHostBcdAddLong((a), (b))
+#define __get_interrupt_state()         halHostGetInterruptState()
+#define __set_interrupt_state(state)    halHostSetInterruptState(state)
+#define DMA_ADDRESS(pointer)            halHostDmaAddress(pointer)
+
+void     halHostDisableInterrupts(void);
+uint32_t halHostBcdAddLong(uint32_t a, uint32_t b);
+uint16_t halHostGetInterruptState(void);
+void     halHostSetInterruptState(uint16_t state);
+uint32_t halHostDmaAddress(const volatile void *pointer);
+
+/************************************************************
+* STATUS REGISTER BITS
+************************************************************/
+
+#define GIE                 (0x0008)
+#define CPUOFF              (0x0010)
+#define OSCOFF              (0x0020)
+#define SCG0                (0x0040)
+#define SCG1                (0x0080)
+
+#define LPM0_bits           (CPUOFF)
+#define LPM1_bits           (SCG0 + CPUOFF)
+#define LPM2_bits           (SCG1 + CPUOFF)
+#define LPM3_bits           (SCG1 + SCG0 + CPUOFF)
+#define LPM4_bits           (SCG1 + SCG0 + OSCOFF + CPUOFF)
+
+/************************************************************
+* GENERIC BITS
+************************************************************/
+
+#define BIT0                (0x0001)
+#define BIT1                (0x0002)
+#define BIT2                (0x0004)
+#define BIT3                (0x0008)
+#define BIT4                (0x0010)
+#define BIT5                (0x0020)
+#define BIT6                (0x0040)
+#define BIT7                (0x0080)
+#define BIT8                (0x0100)
+#define BIT9                (0x0200)
+#define BITA                (0x0400)
+#define BITB                (0x0800)
+#define BITC                (0x1000)
+#define BITD                (0x2000)
+#define BITE                (0x4000)
+#define BITF                (0x8000)
+
+/************************************************************
+* PERIPHERAL BASE ADDRESSES
+************************************************************/
+
+// Modules modelled on the host (enables their DriverLib headers)
+#define __MSP430_HAS_CRC__
+#define __MSP430_HAS_FRAM__
+#define __MSP430_HAS_MPU__
+#define __MSP430_HAS_CS__
+#define __MSP430_HAS_SFR__
+#define __MSP430_HAS_PORT1_R__
+#define __MSP430_HAS_PORTJ_R__
+#define __MSP430_HAS_LCD_C__
+#define __MSP430_HAS_DMAX_3__
+#define __MSP430_HAS_EUSCI_Ax__
+
+#define __MSP430_BASEADDRESS_PORT1_R__  0x0200
+#define __MSP430_BASEADDRESS_PORT3_R__  0x0220
+#define __MSP430_BASEADDRESS_PORT9_R__  0x0280
+#define __MSP430_BASEADDRESS_PORTJ_R__  0x0320
+#define __MSP430_BASEADDRESS_SFR__      0x0100
+#define __MSP430_BASEADDRESS_PMM_FRAM__ 0x0120
+#define __MSP430_BASEADDRESS_CRC__      0x0150
+#define __MSP430_BASEADDRESS_WDT_A__    0x015C
+#define __MSP430_BASEADDRESS_CS__       0x0160
+#define __MSP430_BASEADDRESS_T0A3__     0x0340
+#define __MSP430_BASEADDRESS_T1A3__     0x0380
+#define __MSP430_BASEADDRESS_DMAX_3__   0x0500
+#define __MSP430_BASEADDRESS_MPU__      0x05A0
+#define __MSP430_BASEADDRESS_EUSCI_A1__ 0x05E0
+#define __MSP430_BASEADDRESS_LCD_C__    0x0A00
+
+#define SFR_BASE            __MSP430_BASEADDRESS_SFR__
+#define PMM_BASE            __MSP430_BASEADDRESS_PMM_FRAM__
+#define CRC_BASE            __MSP430_BASEADDRESS_CRC__
+#define WDT_A_BASE          __MSP430_BASEADDRESS_WDT_A__
+#define CS_BASE             __MSP430_BASEADDRESS_CS__
+#define TIMER_A0_BASE       __MSP430_BASEADDRESS_T0A3__
+#define TIMER_A1_BASE       __MSP430_BASEADDRESS_T1A3__
+#define DMA_BASE            __MSP430_BASEADDRESS_DMAX_3__
+#define MPU_BASE            __MSP430_BASEADDRESS_MPU__
+#define EUSCI_A1_BASE       __MSP430_BASEADDRESS_EUSCI_A1__
+#define LCD_C_BASE          __MSP430_BASEADDRESS_LCD_C__
+
+/************************************************************
+* DIGITAL I/O
+************************************************************/
+
+#define P1IN                SFR_8BIT(0x0200)
+#define P1OUT               SFR_8BIT(0x0202)
+#define P1DIR               SFR_8BIT(0x0204)
+#define P1REN               SFR_8BIT(0x0206)
+#define P1SEL0              SFR_8BIT(0x020A)
+#define P1SEL1              SFR_8BIT(0x020C)
+#define P1IES               SFR_8BIT(0x0218)
+#define P1IE                SFR_8BIT(0x021A)
+#define P1IFG               SFR_8BIT(0x021C)
+
+#define P3SEL0              SFR_8BIT(0x022A)
+#define P3SEL1              SFR_8BIT(0x022C)
+
+#define P9IN                SFR_8BIT(0x0280)
+#define P9OUT               SFR_8BIT(0x0282)
+#define P9DIR               SFR_8BIT(0x0284)
+
+#define PJSEL0              SFR_8BIT(0x032A)
+#define PJSEL1              SFR_8BIT(0x032C)
+
+/************************************************************
+* SFR
+************************************************************/
+
+#define SFRIE1              SFR_16BIT(0x0100)
+#define SFRIFG1             SFR_16BIT(0x0102)
+
+#define OFS_SFRIE1_L        (0x0000)
+#define OFS_SFRIFG1_L       (0x0002)
+
+#define OFIE                (0x0002)
+#define OFIFG               (0x0002)
+
+/************************************************************
+* PMM / WATCHDOG
+************************************************************/
+
+#define PM5CTL0             SFR_16BIT(0x0130)
+#define LOCKLPM5            (0x0001)
+
+#define WDTCTL              SFR_16BIT(0x015C)
+#define WDTPW               (0x5A00)
+#define WDTHOLD             (0x0080)
+
+/************************************************************
+* CRC16
+************************************************************/
+
+#define CRCDI               SFR_16BIT(0x0150)
+#define CRCDIRB             SFR_16BIT(0x0152)
+#define CRCINIRES           SFR_16BIT(0x0154)
+#define CRCRESR             SFR_16BIT(0x0156)
+
+#define OFS_CRCDI           (0x0000)
+#define OFS_CRCDI_L         (0x0000)
+#define OFS_CRCDIRB         (0x0002)
+#define OFS_CRCDIRB_L       (0x0002)
+#define OFS_CRCINIRES       (0x0004)
+#define OFS_CRCRESR         (0x0006)
+
+/************************************************************
+* MEMORY PROTECTION UNIT
+************************************************************/
+
+#define MPUCTL0             SFR_16BIT(0x05A0)
+#define MPUCTL1             SFR_16BIT(0x05A2)
+#define MPUSEGB2            SFR_16BIT(0x05A4)
+#define MPUSEGB1            SFR_16BIT(0x05A6)
+#define MPUSAM              SFR_16BIT(0x05A8)
+
+#define OFS_MPUCTL0         (0x0000)
+#define OFS_MPUCTL0_H       (0x0001)
+#define OFS_MPUCTL1         (0x0002)
+#define OFS_MPUSEGB2        (0x0004)
+#define OFS_MPUSEGB1        (0x0006)
+#define OFS_MPUSAM          (0x0008)
+
+#define MPUPW               (0xA500)
+#define MPUENA              (0x0001)
+#define MPULOCK             (0x0002)
+#define MPUSEGIE            (0x0010)
+
+#define MPUSEG1RE           (0x0001)
+#define MPUSEG1WE           (0x0002)
+#define MPUSEG1XE           (0x0004)
+#define MPUSEG2RE           (0x0010)
+#define MPUSEG2WE           (0x0020)
+#define MPUSEG2XE           (0x0040)
+#define MPUSEG3RE           (0x0100)
+#define MPUSEG3WE           (0x0200)
+#define MPUSEG3XE           (0x0400)
+
+/************************************************************
+* CLOCK SYSTEM
+************************************************************/
+
+#define CSCTL0              SFR_16BIT(0x0160)
+#define CSCTL0_H            SFR_8BIT(0x0161)
+#define CSCTL1              SFR_16BIT(0x0162)
+#define CSCTL2              SFR_16BIT(0x0164)
+#define CSCTL3              SFR_16BIT(0x0166)
+#define CSCTL4              SFR_16BIT(0x0168)
+#define CSCTL5              SFR_16BIT(0x016A)
+#define CSCTL6              SFR_16BIT(0x016C)
+
+#define CSKEY               (0xA500)
+#define CSKEY_H             (0xA5)
+
+#define DCOFSEL0            (0x0002)
+#define DCOFSEL1            (0x0004)
+#define DCOFSEL2            (0x0008)
+#define DCORSEL             (0x0040)
+#define DCOFSEL_0           (0x0000)
+#define DCOFSEL_1           (0x0002)
+#define DCOFSEL_2           (0x0004)
+#define DCOFSEL_3           (0x0006)
+#define DCOFSEL_4           (0x0008)
+#define DCOFSEL_5           (0x000A)
+#define DCOFSEL_6           (0x000C)
+
+#define SELM__LFXTCLK       (0x0000)
+#define SELM__VLOCLK        (0x0001)
+#define SELM__LFMODCLK      (0x0002)
+#define SELM__LFMODOSC      (0x0002)
+#define SELM__DCOCLK        (0x0003)
+#define SELM__MODCLK        (0x0004)
+#define SELS__LFXTCLK       (0x0000)
+#define SELS__VLOCLK        (0x0010)
+#define SELS__LFMODCLK      (0x0020)
+#define SELS__DCOCLK        (0x0030)
+#define SELS__MODCLK        (0x0040)
+#define SELA__LFXTCLK       (0x0000)
+#define SELA__VLOCLK        (0x0100)
+#define SELA__LFMODCLK      (0x0200)
+
+#define DIVM__1             (0x0000)
+#define DIVM__2             (0x0001)
+#define DIVM__4             (0x0002)
+#define DIVM__8             (0x0003)
+#define DIVS__1             (0x0000)
+#define DIVS__2             (0x0010)
+#define DIVS__4             (0x0020)
+#define DIVS__8             (0x0030)
+#define DIVA__1             (0x0000)
+#define DIVA__2             (0x0100)
+#define DIVA__4             (0x0200)
+#define DIVA__8             (0x0300)
+
+#define LFXTOFF             (0x0001)
+#define SMCLKOFF            (0x0002)
+#define VLOOFF              (0x0008)
+#define LFXTBYPASS          (0x0010)
+#define LFXTDRIVE0          (0x0040)
+#define LFXTDRIVE1          (0x0080)
+#define LFXTDRIVE_0         (0x0000)
+#define LFXTDRIVE_1         (0x0040)
+#define LFXTDRIVE_2         (0x0080)
+#define LFXTDRIVE_3         (0x00C0)
+#define HFXTOFF             (0x0100)
+#define LFXTOFFG            (0x0001)
+#define HFXTOFFG            (0x0002)
+
+/************************************************************
+* TIMER_A
+************************************************************/
+
+#define TA0CTL              SFR_16BIT(0x0340)
+#define TA0CCTL0            SFR_16BIT(0x0342)
+#define TA0CCTL1            SFR_16BIT(0x0344)
+#define TA0CCTL2            SFR_16BIT(0x0346)
+#define TA0R                SFR_16BIT(0x0350)
+#define TA0CCR0             SFR_16BIT(0x0352)
+#define TA0CCR1             SFR_16BIT(0x0354)
+#define TA0CCR2             SFR_16BIT(0x0356)
+
+#define TA1CTL              SFR_16BIT(0x0380)
+#define TA1CCTL0            SFR_16BIT(0x0382)
+#define TA1CCTL1            SFR_16BIT(0x0384)
+#define TA1CCTL2            SFR_16BIT(0x0386)
+#define TA1R                SFR_16BIT(0x0390)
+#define TA1CCR0             SFR_16BIT(0x0392)
+#define TA1CCR1             SFR_16BIT(0x0394)
+#define TA1CCR2             SFR_16BIT(0x0396)
+
+#define TAIFG               (0x0001)
+#define TAIE                (0x0002)
+#define TACLR               (0x0004)
+#define MC0                 (0x0010)
+#define MC1                 (0x0020)
+#define MC__STOP            (0x0000)
+#define MC__UP              (0x0010)
+#define MC__CONTINUOUS      (0x0020)
+#define MC__UPDOWN          (0x0030)
+#define TASSEL__TACLK       (0x0000)
+#define TASSEL__ACLK        (0x0100)
+#define TASSEL__SMCLK       (0x0200)
+#define TASSEL__INCLK       (0x0300)
+
+#define CCIFG               (0x0001)
+#define COV                 (0x0002)
+#define CCIE                (0x0010)
+#define CAP                 (0x0100)
+#define SCS                 (0x0800)
+#define CCIS0               (0x1000)
+#define CCIS1               (0x2000)
+#define CCIS_2              (0x2000)
+#define CCIS_3              (0x3000)
+#define CM_3                (0xC000)
+
+/************************************************************
+* TIMER_B
+************************************************************/
+
+#define TB0CTL              SFR_16BIT(0x03C0)
+#define TB0CCTL0            SFR_16BIT(0x03C2)
+#define TB0CCTL1            SFR_16BIT(0x03C4)
+#define TB0CCTL2            SFR_16BIT(0x03C6)
+#define TB0R                SFR_16BIT(0x03D0)
+#define TB0CCR0             SFR_16BIT(0x03D2)
+#define TB0CCR1             SFR_16BIT(0x03D4)
+#define TB0CCR2             SFR_16BIT(0x03D6)
+
+#define TBIFG               (0x0001)
+#define TBIE                (0x0002)
+#define TBCLR               (0x0004)
+#define TBSSEL__ACLK        (0x0100)
+
+/************************************************************
+* eUSCI_A1 (UART)
+************************************************************/
+
+#define UCA1CTLW0           SFR_16BIT(0x05E0)
+#define UCA1BRW             SFR_16BIT(0x05E6)
+#define UCA1BR0             SFR_8BIT(0x05E6)
+#define UCA1BR1             SFR_8BIT(0x05E7)
+#define UCA1MCTLW           SFR_16BIT(0x05E8)
+#define UCA1STATW           SFR_16BIT(0x05EA)
+#define UCA1RXBUF           SFR_16BIT(0x05EC)
+#define UCA1IE              SFR_16BIT(0x05FA)
+#define UCA1IFG             SFR_16BIT(0x05FC)
+#define UCA1IV              SFR_16BIT(0x05FE)
+
+// Every byte written to the transmit buffer is captured by the simulator
+volatile uint16_t *halHostUartTxSlot(void);
+#define UCA1TXBUF           (*halHostUartTxSlot())
+
+#define UCSWRST             (0x0001)
+#define UCSSEL__UCLK        (0x0000)
+#define UCSSEL__ACLK        (0x0040)
+#define UCSSEL__SMCLK       (0x0080)
+#define UCOS16              (0x0001)
+#define UCBRF_0             (0x0000)
+#define UCBRF_1             (0x0010)
+#define UCRXIE              (0x0001)
+#define UCTXIE              (0x0002)
+#define UCRXIFG             (0x0001)
+#define UCTXIFG             (0x0002)
+#define UCBUSY              (0x0001)
+
+#define OFS_UCAxTXBUF       (0x000E)
+
+/************************************************************
+* DMA
+************************************************************/
+
+#define DMACTL0             SFR_16BIT(0x0500)
+#define DMAIV               SFR_16BIT(0x050E)
+#define DMA0CTL             SFR_16BIT(0x0510)
+#define DMA0SAL             SFR_16BIT(0x0512)
+#define DMA0SAH             SFR_16BIT(0x0514)
+#define DMA0DAL             SFR_16BIT(0x0516)
+#define DMA0DAH             SFR_16BIT(0x0518)
+#define DMA0SZ              SFR_16BIT(0x051A)
+
+#define OFS_DMA0CTL         (0x0010)
+#define OFS_DMA0SA          (0x0012)
+#define OFS_DMA0DA          (0x0016)
+#define OFS_DMA0SZ          (0x001A)
+
+#define DMAREQ              (0x0001)
+#define DMAABORT            (0x0002)
+#define DMAIE               (0x0004)
+#define DMAIFG              (0x0008)
+#define DMAEN               (0x0010)
+#define DMALEVEL            (0x0020)
+#define DMASRCBYTE          (0x0040)
+#define DMADSTBYTE          (0x0080)
+#define DMASRCINCR_0        (0x0000)
+#define DMASRCINCR_3        (0x0300)
+#define DMADSTINCR_0        (0x0000)
+#define DMADSTINCR_3        (0x0C00)
+#define DMADT_0             (0x0000)
+#define DMADT_4             (0x4000)
+
+/************************************************************
+* LCD_C
+************************************************************/
+
+#define LCDCCTL0            SFR_16BIT(0x0A00)
+#define LCDCCTL1            SFR_16BIT(0x0A02)
+#define LCDCBLKCTL          SFR_16BIT(0x0A04)
+#define LCDCMEMCTL          SFR_16BIT(0x0A06)
+#define LCDCVCTL            SFR_16BIT(0x0A08)
+#define LCDCCPCTL           SFR_16BIT(0x0A12)
+
+#define OFS_LCDCCTL0        (0x0000)
+#define OFS_LCDCCTL1        (0x0002)
+#define OFS_LCDCBLKCTL      (0x0004)
+#define OFS_LCDCMEMCTL      (0x0006)
+#define OFS_LCDCVCTL        (0x0008)
+#define OFS_LCDCCPCTL       (0x0012)
+#define OFS_LCDM1           (0x0020)
+#define OFS_LCDBM1          (0x0040)
+
+#define LCDMEM              ((volatile uint8_t *)&halHostMemory[0x0A20])
+#define LCDBMEM             ((volatile uint8_t *)&halHostMemory[0x0A40])
+
+#define LCDON               (0x0001)
+#define LCDLP               (0x0002)
+#define LCDSON              (0x0004)
+#define LCDMX0              (0x0008)
+#define LCDMX1              (0x0010)
+#define LCDMX2              (0x0020)
+#define LCDSSEL             (0x0040)
+#define LCDPRE0             (0x0100)
+#define LCDDIV0             (0x0800)
+#define LCDPRE_0            (0x0000)
+#define LCDPRE_4            (0x0400)
+#define LCDDIV_0            (0x0000)
+
+#define LCDBLKMOD_0         (0x0000)
+#define LCDBLKMOD_1         (0x0001)
+#define LCDBLKMOD_2         (0x0002)
+#define LCDBLKMOD_3         (0x0003)
+#define LCDBLKPRE0          (0x0004)
+#define LCDBLKPRE1          (0x0008)
+#define LCDBLKPRE2          (0x0010)
+#define LCDBLKDIV0          (0x0020)
+#define LCDBLKDIV1          (0x0040)
+#define LCDBLKDIV2          (0x0080)
+
+#define LCDDISP             (0x0001)
+#define LCDCLRM             (0x0002)
+#define LCDCLRBM            (0x0004)
+
+#define VLCD0               (0x0200)
+#define VLCD1               (0x0400)
+#define VLCD2               (0x0800)
+#define VLCD3               (0x1000)
+#define VLCDREF_0           (0x0000)
+#define LCDREXT             (0x0020)
+#define R03EXT              (0x0040)
+#define LCDEXTBIAS          (0x0080)
+#define VLCDEXT             (0x0010)
+#define LCDCPEN             (0x0008)
+#define LCDCPCLKSYNC        (0x8000)
+
+#endif
@@ -0,0 +1,12 @@
+/******************************************************************************
+ *
+ * FILE: host/msp430fr5xx_6xxgeneric.h
+ *
+ * PURPOSE:
+ *   Empty stand-in for TI's family header, which DriverLib's hw_memmap.h
+ *   includes. Everything the host build needs is in host/msp430.h.
+ *
+ * CREATED BY:
+ *   Hanna Szalai & Haroun Riahi
+ *
+ ******************************************************************************/
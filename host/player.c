@@ -0,0 +1,329 @@
+/******************************************************************************
+ *
+ * FILE: host/player.c
+ *
+ * DESCRIPTION:
+ *   Scripted player for the Linux game runners. It watches the red and
+ *   green LEDs during playback, repeats the flashes with the buttons, and
+ *   reads the final score off the LCD. Each game it makes one mistake in a
+ *   random round, so the score shown must match the rounds it got right.
+ *   Any mismatch or stuck game is reported and counted as a failure.
+ *
+ * CREATED BY:
+ *   Hanna Szalai & Haroun Riahi
+ *
+ ******************************************************************************/
+
+#ifdef HAL_HOST
+
+#include <stdio.h>
+#include "player.h"
+
+// Number of characters on the LCD
+#define LCD_POSITIONS       6
+
+// Highest round the player will make its mistake in
+#define MAX_MISTAKE_ROUND   8
+
+// Button timing of the scripted player
+#define HOLD_MS             50
+#define GAP_MS              50
+
+// Quiet time after the last flash before the player starts repeating
+#define PLAYBACK_DONE_MS    600
+
+// A game that does not move on for this long is stuck
+#define STUCK_MS            60000
+
+// Player states
+#define PLAYER_BOOT         0   // Waiting for the intro LEDs
+#define PLAYER_START        1   // Pressing S1 to start a game
+#define PLAYER_WATCH        2   // Remembering the LED flashes
+#define PLAYER_REPEAT       3   // Pressing the buttons back
+#define PLAYER_SCORE        4   // Waiting for the final score on the LCD
+#define PLAYER_RESTART      5   // Holding both buttons to restart
+
+static const PlayerView *board;
+static uint32_t randomState = 1;
+
+static uint8_t  state = PLAYER_BOOT;
+static uint8_t  lastLeds = 0;
+static uint32_t lastChange = 0;       // Time of the last state or LED change
+static uint32_t nextAction = 0;
+
+static uint8_t  seen[4096];           // Colours seen this round (1 = green)
+static uint16_t seenCount = 0;
+static uint16_t pressIndex = 0;
+static uint8_t  pressButton = 0;      // Button held for the current press
+
+static uint16_t round = 0;
+static uint16_t mistakeRound = 0;
+static uint16_t mistakeStep = 0;
+
+static unsigned long gamesWanted = 1000;
+static unsigned long gamesPlayed = 0;
+static unsigned long failures = 0;
+
+static uint32_t nextRandom(void)
+{
+    randomState ^= randomState << 13;
+    randomState ^= randomState >> 17;
+    randomState ^= randomState << 5;
+    return randomState;
+}
+
+// Turns the segments of one LCD position (0-5) back into a character
+static char readLcdChar(int position)
+{
+    uint8_t nibble[4];
+    uint8_t first;
+    uint8_t second;
+    int i;
+
+    for (i = 0; i < 4; i++)
+    {
+        uint8_t pin = board->charMap[position * 4 + i];
+        nibble[i] = (board->lcdMemory(pin / 2 + 1) >> ((pin & 1) * 4)) & 0x0F;
+    }
+    first = nibble[0] | (nibble[1] << 4);
+    second = nibble[2] | (nibble[3] << 4);
+
+    if (first == 0 && second == 0)
+    {
+        return ' ';
+    }
+    for (i = 0; i < 10; i++)
+    {
+        if (board->digits[i * 2] == first && board->digits[i * 2 + 1] == second)
+        {
+            return '0' + i;
+        }
+    }
+    return '?';
+}
+
+// Returns the number shown on the LCD, or -1 if it is not showing one.
+// The digits may sit anywhere with blanks around them: older firmware
+// builds print the score from the left instead of right-aligning it.
+static long readLcdNumber(void)
+{
+    long value = 0;
+    int digits = 0;
+    int ended = 0;
+    int i;
+    char c;
+
+    for (i = 0; i < LCD_POSITIONS; i++)
+    {
+        c = readLcdChar(i);
+        if (c >= '0' && c <= '9' && !ended)
+        {
+            value = value * 10 + (c - '0');
+            digits++;
+        }
+        else if (c == ' ')
+        {
+            ended = digits;
+        }
+        else
+        {
+            return -1;
+        }
+    }
+
+    return digits ? value : -1;
+}
+
+static void setState(uint8_t newState, uint32_t now)
+{
+    state = newState;
+    lastChange = now;
+}
+
+static void startGame(uint32_t now)
+{
+    round = 0;
+    seenCount = 0;
+    mistakeRound = nextRandom() % MAX_MISTAKE_ROUND;
+    nextAction = now + 100 + nextRandom() % 1000;
+    setState(PLAYER_START, now);
+}
+
+void playerStart(const PlayerView *view, unsigned long games, uint32_t seed)
+{
+    board = view;
+    gamesWanted = games;
+    randomState = seed | 1;
+    gamesPlayed = 0;
+    failures = 0;
+    lastLeds = 0;
+    lastChange = 0;
+    setState(PLAYER_BOOT, 0);
+}
+
+uint8_t playerButtons(uint32_t now)
+{
+    uint8_t leds = board->leds();
+    uint8_t buttons = 0;
+    long score;
+
+    if (leds != lastLeds)
+    {
+        lastChange = now;
+    }
+
+    if (now - lastChange > STUCK_MS)
+    {
+        printf("game %lu: stuck in player state %d at round %u\n",
+               gamesPlayed + 1, state, round);
+        failures++;
+        lastChange = now;
+        board->stop(2);
+    }
+
+    switch (state)
+    {
+    case PLAYER_BOOT:
+        // Both LEDs light up while the intro message scrolls
+        if (leds == (PLAYER_LED_RED | PLAYER_LED_GREEN))
+        {
+            startGame(now);
+        }
+        break;
+
+    case PLAYER_START:
+        if (leds == 0)
+        {
+            // The game has started and switched the LEDs off
+            setState(PLAYER_WATCH, now);
+        }
+        else if (now >= nextAction)
+        {
+            buttons = PLAYER_BUTTON_S1;
+            if (now >= nextAction + HOLD_MS)
+            {
+                // Not started yet (still scrolling), try again later
+                nextAction = now + 500;
+                buttons = 0;
+            }
+        }
+        break;
+
+    case PLAYER_WATCH:
+        if (leds && !lastLeds)
+        {
+            seen[seenCount++] = (leds & PLAYER_LED_GREEN) ? 1 : 0;
+        }
+        else if (!leds && seenCount && now - lastChange >= PLAYBACK_DONE_MS)
+        {
+            if (round == mistakeRound)
+            {
+                mistakeStep = nextRandom() % seenCount;
+            }
+            pressIndex = 0;
+            pressButton = 0;
+            nextAction = now;
+            setState(PLAYER_REPEAT, now);
+        }
+        break;
+
+    case PLAYER_REPEAT:
+        if (now < nextAction)
+        {
+            buttons = pressButton;
+        }
+        else if (pressButton)
+        {
+            // Let go of the button and wait a little before the next one
+            pressButton = 0;
+            pressIndex++;
+            nextAction = now + GAP_MS;
+        }
+        else if (pressIndex == seenCount || (round == mistakeRound && pressIndex > mistakeStep))
+        {
+            if (round == mistakeRound)
+            {
+                setState(PLAYER_SCORE, now);
+            }
+            else
+            {
+                round++;
+                seenCount = 0;
+                setState(PLAYER_WATCH, now);
+            }
+        }
+        else
+        {
+            uint8_t green = seen[pressIndex];
+
+            if (round == mistakeRound && pressIndex == mistakeStep)
+            {
+                green = !green;
+            }
+            pressButton = green ? PLAYER_BUTTON_S2 : PLAYER_BUTTON_S1;
+            buttons = pressButton;
+            nextAction = now + HOLD_MS;
+        }
+        break;
+
+    case PLAYER_SCORE:
+        score = readLcdNumber();
+        if (score >= 0)
+        {
+            if (score != mistakeRound)
+            {
+                printf("game %lu: LCD shows score %ld, expected %u\n",
+                       gamesPlayed + 1, score, mistakeRound);
+                failures++;
+            }
+            setState(PLAYER_RESTART, now);
+        }
+        break;
+
+    case PLAYER_RESTART:
+        buttons = PLAYER_BUTTON_S1 | PLAYER_BUTTON_S2;
+        if (leds == (PLAYER_LED_RED | PLAYER_LED_GREEN))
+        {
+            // Next game's intro is showing
+            gamesPlayed++;
+            if (gamesPlayed >= gamesWanted)
+            {
+                board->stop(failures ? 1 : 0);
+            }
+            startGame(now);
+            buttons = 0;
+        }
+        break;
+    }
+
+    lastLeds = leds;
+    return buttons;
+}
+
+uint8_t playerPhase(void)
+{
+    switch (state)
+    {
+    case PLAYER_WATCH:
+        return seenCount ? PLAYER_PHASE_PLAYBACK : PLAYER_PHASE_BANNER;
+    case PLAYER_REPEAT:
+        return PLAYER_PHASE_INPUT;
+    case PLAYER_SCORE:
+    case PLAYER_RESTART:
+        return PLAYER_PHASE_GAMEOVER;
+    default:
+        return PLAYER_PHASE_INTRO;
+    }
+}
+
+unsigned long playerGamesPlayed(void)
+{
+    return gamesPlayed;
+}
+
+unsigned long playerFailures(void)
+{
+    return failures;
+}
+
+#endif
@@ -0,0 +1,62 @@
+/******************************************************************************
+ *
+ * FILE: host/player.h
+ *
+ * PURPOSE:
+ *   Declares the scripted player shared by the Linux game runners
+ *   (simGame on the register model, msp430Emu on the instruction-set
+ *   emulator). The player only uses what a person would see: the two
+ *   LEDs and the segments of the LCD. Each game it makes one mistake in
+ *   a random round and checks that the score on the LCD matches.
+ *
+ * CREATED BY:
+ *   Hanna Szalai & Haroun Riahi
+ *
+ ******************************************************************************/
+
+#ifndef HOST_PLAYER_H_
+#define HOST_PLAYER_H_
+
+#include <stdint.h>
+
+// LED bits returned by PlayerView.leds
+#define PLAYER_LED_RED          0x01
+#define PLAYER_LED_GREEN        0x02
+
+// Button bits returned by playerButtons() (the port 1 pins of S1 and S2)
+#define PLAYER_BUTTON_S1        0x02
+#define PLAYER_BUTTON_S2        0x04
+
+// Game phases returned by playerPhase(), the ones the firmware reports
+#define PLAYER_PHASE_INTRO      0   // Intro text until a game starts
+#define PLAYER_PHASE_BANNER     1   // Level banner, before the first flash
+#define PLAYER_PHASE_PLAYBACK   2   // LED flashes
+#define PLAYER_PHASE_INPUT      3   // Pressing the flashes back
+#define PLAYER_PHASE_GAMEOVER   4   // Final score until the next intro
+#define PLAYER_PHASE_COUNT      5
+
+// How the player looks at the board
+typedef struct
+{
+    uint8_t (*leds)(void);                  // Lit LEDs, PLAYER_LED_* bits
+    uint8_t (*lcdMemory)(uint8_t index);    // Segment byte of LCDMx (1-based)
+    const uint8_t *charMap;                 // Pins of each position [6][4]
+    const uint8_t *digits;                  // Segments of '0'-'9' [10][2]
+    void (*stop)(int code);                 // Ends the run (0 = all games passed)
+} PlayerView;
+
+// Starts a run of games; the seed picks the rounds the mistakes are made in
+void playerStart(const PlayerView *view, unsigned long games, uint32_t seed);
+
+// Called every 10 ms of simulated time, returns the buttons held down
+uint8_t playerButtons(uint32_t timeMs);
+
+// Phase of the game the player is in, from what it has seen so far. The
+// runners charge CPU time to it, so the phases are the same for every
+// firmware image, including ones that do not track phases themselves.
+uint8_t playerPhase(void);
+
+unsigned long playerGamesPlayed(void);
+unsigned long playerFailures(void);
+
+#endif
@@ -0,0 +1,114 @@
+/******************************************************************************
+ *
+ * FILE: host/simGame.c
+ *
+ * DESCRIPTION:
+ *   Plays the memory game on Linux with a scripted player, as fast as
+ *   the host can run it. The unchanged game code (main.c, lcdDisplay.c,
+ *   ...) runs on top of the register model in halHost.c.
+ *
+ *   The scripted player in player.c only uses what a person would see:
+ *   the LEDs and the LCD. Each game it makes one mistake in a random
+ *   round, so the score shown must match the rounds it got right. Any
+ *   mismatch or stuck game makes the run fail, which turns this into a
+ *   regression test for the game logic.
+ *
+ * BUILD AND RUN (from the repository root):
+ *   gcc -O2 -DHAL_HOST -Wno-unknown-pragmas -Ihost -I. \
+ *       -Idriverlib/MSP430FR5xx_6xx *.c host/halHost.c \
+ *       host/driverlibHost.c host/player.c host/simGame.c -o simGame
+ *   ./simGame [games] [seed] [capture]
+ *
+ *   With a capture file name, everything the game sends over the UART
+ *   (text and telemetry frames) is written to that file, ready for
+ *   host/telemetryDecode.c.
+ *
+ * CREATED BY:
+ *   Hanna Szalai & Haroun Riahi
+ *
+ ******************************************************************************/
+
+#ifdef HAL_HOST
+
+#define HAL_HOST_PROGRAM
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <lcdDisplay.h>
+#include "halHost.h"
+#include "player.h"
+
+extern const uint8_t CharMap[LCD_NUM_CHAR][4];
+
+static const PlayerView board =
+{
+    halHostLeds,
+    halHostLcdMemory,
+    &CharMap[0][0],
+    (const uint8_t *)&lcdGlyphs['0'][0],
+    halHostStop
+};
+
+static FILE *capture = 0;
+
+static void captureUartByte(uint8_t byte)
+{
+    fputc(byte, capture);
+}
+
+int main(int argc, char *argv[])
+{
+    clock_t started;
+    double seconds;
+    int result;
+    unsigned long games = 1000;
+    uint32_t seed = 1;
+
+    if (argc > 1)
+    {
+        games = strtoul(argv[1], NULL, 10);
+    }
+    if (argc > 2)
+    {
+        seed = strtoul(argv[2], NULL, 10);
+    }
+    if (argc > 3)
+    {
+        capture = fopen(argv[3], "wb");
+        if (!capture)
+        {
+            perror(argv[3]);
+            return 1;
+        }
+    }
+
+    halHostReset();
+    playerStart(&board, games, seed);
+    halHostSetInput(playerButtons);
+    if (capture)
+    {
+        halHostSetUartOutput(captureUartByte);
+    }
+
+    started = clock();
+    result = halHostRun();
+    seconds = (double)(clock() - started) / CLOCKS_PER_SEC;
+
+    if (capture)
+    {
+        // Takes the last byte out of the transmit slot too
+        halHostUartCount();
+        fclose(capture);
+    }
+
+    printf("games played:   %lu\n", playerGamesPlayed());
+    printf("failures:       %lu\n", playerFailures());
+    printf("simulated time: %.1f h\n", halHostTimeMs() / 3600000.0);
+    printf("host time:      %.3f s (%.0f games/s)\n",
+           seconds, seconds > 0 ? playerGamesPlayed() / seconds : 0.0);
+
+    return result;
+}
+
+#endif
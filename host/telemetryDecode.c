@@ -0,0 +1,282 @@
+/******************************************************************************
+ *
+ * FILE: host/telemetryDecode.c
+ *
+ * DESCRIPTION:
+ *   Turns a capture of the game's serial output into CSV, one row per
+ *   telemetry frame (telemetry.h), for a spreadsheet or a script:
+ *     time_ms,event,round,step,colour,correct,reaction_us,hold_us,points,won
+ *   The capture can be a file or the serial port itself on stdin.
+ *
+ *   Frames are found by their sync byte. A frame is only taken when its
+ *   length is possible and its CRC16 matches; otherwise the decoder moves
+ *   on by one byte and looks for the next sync byte, so a corrupt or cut
+ *   off frame costs only that frame. The text lines the game prints in
+ *   between are skipped the same way. A count of good frames, bad frames
+ *   and skipped bytes goes to stderr at the end.
+ *
+ *   The CRC is worked out in software the way the CRC module does it
+ *   for CRC_set8BitData: CRC-CCITT with each byte shifted in LSB first.
+ *
+ *   A score store frame becomes a games_played row and a high_score row
+ *   for each entry of the high-score table, best first, with the number
+ *   in the points column.
+ *
+ * BUILD AND RUN (from the repository root):
+ *   gcc -O2 -DHAL_HOST -I. host/telemetryDecode.c -o telemetryDecode
+ *   ./simGame 10 1 capture.bin
+ *   ./telemetryDecode capture.bin > game.csv
+ *
+ * CREATED BY:
+ *   Hanna Szalai & Haroun Riahi
+ *
+ ******************************************************************************/
+
+#ifdef HAL_HOST
+
+#include <stdio.h>
+#include <string.h>
+#include "telemetry.h"
+#include "sequence.h"
+#include "scoreStore.h"
+
+#define FRAME_MAX       (TELEMETRY_MAX_LENGTH + TELEMETRY_OVERHEAD)
+
+// Offsets in a frame
+#define FRAME_LENGTH    1
+#define FRAME_TYPE      2
+#define FRAME_PAYLOAD   3
+
+// Every payload starts with the 32-bit time
+#define TIME_BYTES      4
+
+// Score store record: magic, high scores, games played, last game
+// recorded, games by points
+#define STORE_HIGH_SCORES   2
+#define STORE_GAMES         (STORE_HIGH_SCORES + 2 * SCORE_TABLE_SIZE)
+#define STORE_BYTES         (STORE_GAMES + 4 + 4 + 4 * (SCORE_LEVELS + 1))
+
+static unsigned long goodFrames = 0;
+static unsigned long badFrames = 0;
+static unsigned long unknownFrames = 0;
+static unsigned long skippedBytes = 0;
+
+static uint16_t crcByte(uint16_t crc, uint8_t data)
+{
+    uint8_t bit;
+
+    for (bit = 0; bit < 8; bit++)
+    {
+        crc = ((crc >> 15) ^ ((data >> bit) & 1)) ? (crc << 1) ^ 0x1021 : crc << 1;
+    }
+    return crc;
+}
+
+static uint16_t get16(const uint8_t *bytes)
+{
+    return bytes[0] | (bytes[1] << 8);
+}
+
+static uint32_t get32(const uint8_t *bytes)
+{
+    return get16(bytes) | ((uint32_t)get16(bytes + 2) << 16);
+}
+
+static const char *colourName(uint8_t colour)
+{
+    return colour == STEP_RED ? "red" : "green";
+}
+
+// Rows of a score store frame; the table is kept in no particular order
+static void printScoreStore(uint32_t timeMs, const uint8_t *store)
+{
+    uint16_t scores[SCORE_TABLE_SIZE];
+    uint16_t score;
+    int i;
+    int j;
+
+    printf("%lu,games_played,,,,,,,%lu,\n", (unsigned long)timeMs,
+           (unsigned long)get32(store + STORE_GAMES));
+
+    for (i = 0; i < SCORE_TABLE_SIZE; i++)
+    {
+        score = get16(store + STORE_HIGH_SCORES + 2 * i);
+        for (j = i; j > 0 && scores[j - 1] < score; j--)
+        {
+            scores[j] = scores[j - 1];
+        }
+        scores[j] = score;
+    }
+    for (i = 0; i < SCORE_TABLE_SIZE; i++)
+    {
+        printf("%lu,high_score,,,,,,,%u,\n", (unsigned long)timeMs, scores[i]);
+    }
+}
+
+// Prints the row of a frame whose CRC matched; 0 if its type or length
+// is not one this decoder knows
+static int printFrame(uint8_t type, const uint8_t *payload, uint8_t length)
+{
+    uint32_t timeMs = get32(payload);
+    const uint8_t *fields = payload + TIME_BYTES;
+
+    switch (type)
+    {
+    case TELEMETRY_ROUND_START:
+        if (length != TIME_BYTES + 2)
+        {
+            return 0;
+        }
+        printf("%lu,round_start,%u,,,,,,,\n", (unsigned long)timeMs, get16(fields));
+        break;
+
+    case TELEMETRY_PLAYBACK:
+        if (length != TIME_BYTES + 5)
+        {
+            return 0;
+        }
+        printf("%lu,playback,%u,%u,%s,,,,,\n", (unsigned long)timeMs, get16(fields),
+               get16(fields + 2), colourName(fields[4]));
+        break;
+
+    case TELEMETRY_PRESS:
+        if (length != TIME_BYTES + 14)
+        {
+            return 0;
+        }
+        printf("%lu,press,%u,%u,%s,%u,%lu,%lu,,\n", (unsigned long)timeMs, get16(fields),
+               get16(fields + 2), colourName(fields[4]), fields[5],
+               (unsigned long)get32(fields + 6), (unsigned long)get32(fields + 10));
+        break;
+
+    case TELEMETRY_RESULT:
+        if (length != TIME_BYTES + 3)
+        {
+            return 0;
+        }
+        printf("%lu,result,,,,,,,%u,%u\n", (unsigned long)timeMs, get16(fields), fields[2]);
+        break;
+
+    case TELEMETRY_SCORE_STORE:
+        if (length != TIME_BYTES + STORE_BYTES)
+        {
+            return 0;
+        }
+        printScoreStore(timeMs, fields);
+        break;
+
+    default:
+        return 0;
+    }
+
+    return 1;
+}
+
+// Looks at the start of the window. Returns how many bytes to drop from
+// it, or 0 when more bytes are needed to decide.
+static unsigned int decode(const uint8_t *window, unsigned int count)
+{
+    uint8_t length;
+    uint16_t crc = TELEMETRY_CRC_SEED;
+    unsigned int i;
+
+    if (window[0] != TELEMETRY_SYNC)
+    {
+        skippedBytes++;
+        return 1;
+    }
+    if (count <= FRAME_LENGTH)
+    {
+        return 0;
+    }
+
+    length = window[FRAME_LENGTH];
+    if (length < TIME_BYTES)
+    {
+        badFrames++;
+        return 1;
+    }
+    if (count < (unsigned int)length + TELEMETRY_OVERHEAD)
+    {
+        return 0;
+    }
+
+    for (i = FRAME_LENGTH; i < (unsigned int)FRAME_PAYLOAD + length; i++)
+    {
+        crc = crcByte(crc, window[i]);
+    }
+    if (crc != get16(&window[FRAME_PAYLOAD + length]))
+    {
+        badFrames++;
+        return 1;
+    }
+
+    if (printFrame(window[FRAME_TYPE], &window[FRAME_PAYLOAD], length))
+    {
+        goodFrames++;
+    }
+    else
+    {
+        unknownFrames++;
+    }
+    fflush(stdout);
+
+    return length + TELEMETRY_OVERHEAD;
+}
+
+int main(int argc, char *argv[])
+{
+    FILE *input = stdin;
+    uint8_t window[FRAME_MAX];
+    unsigned int count = 0;
+    unsigned int used;
+    int c;
+
+    if (argc > 1 && strcmp(argv[1], "-") != 0)
+    {
+        input = fopen(argv[1], "rb");
+        if (!input)
+        {
+            perror(argv[1]);
+            return 1;
+        }
+    }
+
+    printf("time_ms,event,round,step,colour,correct,reaction_us,hold_us,points,won\n");
+
+    while ((c = getc(input)) != EOF)
+    {
+        window[count++] = (uint8_t)c;
+
+        while (count && (used = decode(window, count)) != 0)
+        {
+            count -= used;
+            memmove(window, window + used, count);
+        }
+    }
+
+    // A frame cut off at the end of the capture. Another frame can still
+    // start after its sync byte.
+    while (count)
+    {
+        used = decode(window, count);
+        if (!used)
+        {
+            badFrames++;
+            used = 1;
+        }
+        count -= used;
+        memmove(window, window + used, count);
+    }
+
+    fprintf(stderr, "frames: %lu good, %lu bad, %lu unknown; %lu other bytes skipped\n",
+            goodFrames, badFrames, unknownFrames, skippedBytes);
+
+    if (input != stdin)
+    {
+        fclose(input);
+    }
+    return 0;
+}
+
+#endif
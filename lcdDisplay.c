@@ -20,52 +20,16 @@
 
 #include "driverlib.h"
 #include <lcdDisplay.h>
+#include <lcdGlyphs.h>
+#include <clockConfig.h>
+#include <profiler.h>
 #include "string.h"
 
-// Alphabet segment mappings for A-Z from the previous lab
-const char alphabetBig[26][2] =
-{
-    {0xEF, 0x00},  /* "A" LCD segments a+b+c+e+f+g+m */
-    {0xF1, 0x50},  /* "B" */
-    {0x9C, 0x00},  /* "C" */
-    {0xF0, 0x50},  /* "D" */
-    {0x9F, 0x00},  /* "E" */
-    {0x8F, 0x00},  /* "F" */
-    {0xBD, 0x00},  /* "G" */
-    {0x6F, 0x00},  /* "H" */
-    {0x90, 0x50},  /* "I" */
-    {0x78, 0x00},  /* "J" */
-    {0x0E, 0x22},  /* "K" */
-    {0x1C, 0x00},  /* "L" */
-    {0x6C, 0xA0},  /* "M" */
-    {0x6C, 0x82},  /* "N" */
-    {0xFC, 0x00},  /* "O" */
-    {0xCF, 0x00},  /* "P" */
-    {0xFC, 0x02},  /* "Q" */
-    {0xCF, 0x02},  /* "R" */
-    {0xB7, 0x00},  /* "S" */
-    {0x80, 0x50},  /* "T" */
-    {0x7C, 0x00},  /* "U" */
-    {0x0C, 0x28},  /* "V" */
-    {0x6C, 0x0A},  /* "W" */
-    {0x00, 0xAA},  /* "X" */
-    {0x00, 0xB0},  /* "Y" */
-    {0x90, 0x28}   /* "Z" */
-};
-
-// Number patterns for 0-9
-const char digit[10][2] =
-{
-    {0xFC, 0x28},  /* "0" LCD segments a+b+c+d+e+f+k+q */
-    {0x60, 0x20},  /* "1" */
-    {0xDB, 0x00},  /* "2" */
-    {0xF3, 0x00},  /* "3" */
-    {0x67, 0x00},  /* "4" */
-    {0xB7, 0x00},  /* "5" */
-    {0xBF, 0x00},  /* "6" */
-    {0xE4, 0x00},  /* "7" */
-    {0xFF, 0x00},  /* "8" */
-    {0xF7, 0x00}   /* "9" */
+// Glyph table for the 7-bit characters and the degree sign, expanded from
+// lcdGlyphs.h. Characters missing from the lists are left blank.
+const char lcdGlyphs[ LCD_GLYPH_COUNT ][ 2 ] =
+{
+    LCD_GLYPH_TABLE
 };
 
 // Segment definitions for display character positions
@@ -79,6 +43,46 @@ const uint8_t CharMap[ LCD_NUM_CHAR ][ 4 ] =
         { 14, 15, 16, 17 }
 };
 
+// LCDMEM bytes of each character position (CharMap pins / 2). With 4-mux
+// a byte holds two pins, so every character is two whole bytes and the
+// glyph tables above are already in LCDMEM layout
+static const uint8_t CharMemory[ LCD_NUM_CHAR ][ 2 ] =
+{
+        {  9, 10 },
+        {  5,  6 },
+        {  3,  4 },
+        { 18, 19 },
+        { 14, 15 },
+        {  7,  8 }
+};
+
+// RAM shadow of the character cells: lcdStaged is the next frame, lcdBank
+// what each memory bank holds (0 = LCDMEM, 1 = LCDBMEM). LCD_commit writes
+// only the bytes that differ.
+static char    lcdStaged[ LCD_NUM_CHAR ][ 2 ];
+static char    lcdBank[ 2 ][ LCD_NUM_CHAR ][ 2 ];
+static uint8_t lcdDirty[ 2 ] = { 0, 0 };                                        // One bit per cell staged differently from the bank
+
+// In double-buffer mode frames are built in the bank that is not on the
+// glass and shown by flipping LCDDISP
+static uint8_t lcdDoubleBuffer = 0;
+
+// While blinking, LCDBMEM holds the blink mask and LCD_C forces LCDDISP
+// to 0, so every frame goes to LCDMEM; lcdBlinkHz is 0 when not blinking
+static uint8_t  lcdBlinkHz = 0;
+static uint32_t lcdAclk = 0;
+
+// Bits of a character position's second byte that belong to symbols
+#define CELL_SYMBOL_BITS    ( BIT0 | BIT2 )
+
+// LCDM1 to LCDM22 hold segment lines 0 to 43 with 4-mux
+#define LCD_MEMORY_BYTES    22
+
+// LCDMEM bytes LCD_commit wrote, and bytes a full repaint would have written
+// but were already correct
+static uint32_t lcdBytesWritten = 0;
+static uint32_t lcdBytesSaved   = 0;
+
 
 LCD_C_initParam initParams = {
     LCD_C_CLOCKSOURCE_ACLK,
@@ -89,9 +93,95 @@ LCD_C_initParam initParams = {
     LCD_C_SEGMENTS_ENABLED
 };
 
+// Sets the LCD_C divider and prescaler that bring ACLK down to LCD_FRAME_HZ
+// as closely as they can: the prescaler is the smallest power of two that
+// lets the divider (1 to 32) cover the rest
+static void setLcdClockDividers( uint32_t aclk )
+{
+    uint32_t total = ( aclk + 4 * LCD_FRAME_HZ ) / ( 8 * LCD_FRAME_HZ );
+    uint32_t divider = total;
+    uint8_t  prescaler = 0;
+
+    while ( divider > 32 && prescaler < 5 )
+    {
+        prescaler++;
+        divider = ( total + ( 1UL << prescaler ) / 2 ) >> prescaler;
+    }
+    if ( divider > 32 )
+    {
+        divider = 32;
+    }
+    if ( divider < 1 )
+    {
+        divider = 1;
+    }
+
+    initParams.clockDivider   = ( uint16_t )( ( divider - 1 ) * LCDDIV0 );
+    initParams.clockPrescalar = ( uint16_t )( prescaler * LCDPRE0 );
+}
+
+// Blink control bits for a blink rate: fBLINK = ACLK / ( div * 2^( 9 + pre ) ),
+// with the prescaler the smallest that lets the divider (1 to 8) cover the rest
+static uint16_t blinkDividers( uint32_t aclk, uint8_t hz )
+{
+    uint32_t total = ( aclk + 256UL * hz ) / ( 512UL * hz );
+    uint32_t divider = total;
+    uint8_t  prescaler = 0;
+
+    while ( divider > 8 && prescaler < 7 )
+    {
+        prescaler++;
+        divider = ( total + ( 1UL << prescaler ) / 2 ) >> prescaler;
+    }
+    if ( divider > 8 )
+    {
+        divider = 8;
+    }
+    if ( divider < 1 )
+    {
+        divider = 1;
+    }
+
+    return ( uint16_t )( ( divider - 1 ) * LCDBLKDIV0 | prescaler * LCDBLKPRE0 );
+}
+
+// Sets the blink rate and mode; a rate of 0 turns blinking off
+static void setBlinking( uint32_t aclk )
+{
+    uint16_t dividers;
+
+    if ( !lcdBlinkHz )
+    {
+        LCD_C_setBlinkingControl( LCD_C_BASE, 0, 0, LCD_C_BLINK_MODE_DISABLED );
+        return;
+    }
+    dividers = blinkDividers( aclk, lcdBlinkHz );
+    LCD_C_setBlinkingControl( LCD_C_BASE, ( uint8_t )( dividers & ( 7 * LCDBLKDIV0 ) ),
+                              ( uint8_t )( dividers & ( 7 * LCDBLKPRE0 ) ),
+                              LCD_C_BLINK_MODE_INDIVIDUAL_SEGMENTS );
+}
+
+// ACLK changed: the dividers can only be set with the LCD off. LCD_C_init
+// ORs the prescaler in without clearing the old one, so that is done here;
+// the memory and the blinking settings are left alone.
+static void lcdClockChanged( uint32_t aclk )
+{
+    lcdAclk = aclk;
+    setLcdClockDividers( aclk );
+    LCD_C_off( LCD_C_BASE );
+    LCDCCTL0 &= ~( 7 * LCDPRE0 | 31 * LCDDIV0 );
+    LCD_C_init( LCD_C_BASE, &initParams );
+    LCD_C_on( LCD_C_BASE );
+    setBlinking( aclk );
+}
+
 // Initializes all LCD settings
 void LCD_init()
 {
+    lcdAclk = clockRequest( CLOCK_ACLK, LCD_CLOCK_MIN_HZ );
+    setLcdClockDividers( lcdAclk );
+    clockWatch( CLOCK_ACLK, lcdClockChanged );
+
     LCD_C_off( LCD_C_BASE );
     LCD_C_setPinAsLCDFunctionEx( LCD_C_BASE,
             LCD_C_SEGMENT_LINE_0,
@@ -113,97 +203,357 @@ void LCD_init()
     LCD_C_configChargePump( LCD_C_BASE, LCD_C_SYNCHRONIZATION_ENABLED, 0 );
     LCD_C_clearMemory( LCD_C_BASE );
     LCD_C_clearBlinkingMemory( LCD_C_BASE );
+    memset( lcdStaged, 0, sizeof( lcdStaged ) );
+    memset( lcdBank, 0, sizeof( lcdBank ) );
+    lcdDirty[0] = 0;
+    lcdDirty[1] = 0;
     LCD_C_selectDisplayMemory( LCD_C_BASE, LCD_C_DISPLAYSOURCE_MEMORY );
-    LCD_C_setBlinkingControl( LCD_C_BASE, LCDBLKPRE1, LCDBLKPRE2, LCD_C_BLINK_MODE_DISABLED );
+    lcdBlinkHz = 0;
+    setBlinking( 0 );
     LCD_C_on( LCD_C_BASE );
 }
 
-void LCD_showChar(char c, int Position)
+// Segment bytes of a character. Codes above 127 other than the degree
+// sign are blank.
+static const char *lookupGlyph( char c )
 {
-    Position -= 1;
-    if ( ( Position >= 0 ) && ( Position <= 6 ) )
-    {
-        if ( c == ' ' )
-        {
-            LCD_C_setMemory( LCD_C_BASE, CharMap[Position][0], 0 );
-            LCD_C_setMemory( LCD_C_BASE, CharMap[Position][1], 0 );
-            LCD_C_setMemory( LCD_C_BASE, CharMap[Position][2], 0 );
-            LCD_C_setMemory( LCD_C_BASE, CharMap[Position][3], 0 );
-        }
-        else if ( c >= '0' && c <= '9' )
-        {
-            LCD_C_setMemory( LCD_C_BASE, CharMap[Position][0], digit[c-48][0] );
-            LCD_C_setMemory( LCD_C_BASE, CharMap[Position][1], digit[c-48][0] >> 4 );
-            LCD_C_setMemory( LCD_C_BASE, CharMap[Position][2], digit[c-48][1] );
-            LCD_C_setMemory( LCD_C_BASE, CharMap[Position][3], digit[c-48][1] >> 4 );
-        }
-        else if ( c >= 'A' && c <= 'Z' )
-        {
-            LCD_C_setMemory( LCD_C_BASE, CharMap[Position][0], alphabetBig[c-65][0] );
-            LCD_C_setMemory( LCD_C_BASE, CharMap[Position][1], alphabetBig[c-65][0] >> 4 );
-            LCD_C_setMemory( LCD_C_BASE, CharMap[Position][2], alphabetBig[c-65][1] );
-            LCD_C_setMemory( LCD_C_BASE, CharMap[Position][3], alphabetBig[c-65][1] >> 4 );
-        }
-        else
-        {
-            LCD_C_setMemory( LCD_C_BASE, CharMap[Position][0], 0xFF );
-            LCD_C_setMemory( LCD_C_BASE, CharMap[Position][1], 0xFF );
-            LCD_C_setMemory( LCD_C_BASE, CharMap[Position][2], 0xFF );
-            LCD_C_setMemory( LCD_C_BASE, CharMap[Position][3], 0xFF );
-        }
-    }
+    return lcdGlyphs[ LCD_GLYPH_INDEX( ( uint8_t )c ) ];
 }
 
-void LCD_displayNumber( unsigned long val )
+// Index of the bank on the glass
+static uint8_t frontBank( void )
+{
+    return ( LCDCMEMCTL & LCDDISP ) ? 1 : 0;
+}
+
+static volatile uint8_t *bankMemory( uint8_t bank )
 {
-    unsigned long div[6];
-    unsigned long mod[6];
-    unsigned long err;
+    return bank ? LCDBMEM : LCDMEM;
+}
 
-    err = val / 1000000;
-    if ( err > 0 )
+// Marks a cell dirty in a bank if its staged glyph differs from the bank
+static void markCell( uint8_t bank, int cell )
+{
+    if ( ( lcdStaged[cell][0] != lcdBank[bank][cell][0] ) || ( lcdStaged[cell][1] != lcdBank[bank][cell][1] ) )
     {
-        LCD_showChar( ' ', 1 );
-        LCD_showChar( 'E', 2 );
-        LCD_showChar( 'R', 3 );
-        LCD_showChar( 'R', 4 );
-        LCD_showChar( 'O', 5 );
-        LCD_showChar( 'R', 6 );
+        lcdDirty[bank] |= ( 1 << cell );
     }
     else
     {
-        div[0] = val / 100000  ;
-        mod[0] = val % 100000  ;
-        div[1] = mod[0] / 10000;
-        mod[1] = mod[0] % 10000;
-        div[2] = mod[1] / 1000 ;
-        mod[2] = mod[1] % 1000 ;
-        div[3] = mod[2] / 100  ;
-        mod[3] = mod[2] % 100  ;
-        div[4] = mod[3] / 10   ;
-        div[5] = mod[3] % 10   ;
-
-        int i = 0;
-        int LeadingZeros = 0;
-
-        for ( i = 0; i < ( LCD_NUM_CHAR - 1); i++ )
+        lcdDirty[bank] &= ~( 1 << cell );
+    }
+}
+
+// Writes the staged cells that differ into one bank
+static void commitBank( uint8_t bank )
+{
+    volatile uint8_t *memory = bankMemory( bank );
+    uint8_t cell;
+    uint8_t half;
+
+    for ( cell = 0; cell < LCD_NUM_CHAR; cell++ )
+    {
+        if ( !( lcdDirty[bank] & ( 1 << cell ) ) )
+        {
+            lcdBytesSaved += 2;
+            continue;
+        }
+        for ( half = 0; half < 2; half++ )
         {
-            if ( ( div[i] == 0 ) && ( !LeadingZeros ) )
+            if ( lcdStaged[cell][half] != lcdBank[bank][cell][half] )
             {
-                LCD_showChar( ' ', i + 1 );
+                memory[ CharMemory[cell][half] ] = lcdStaged[cell][half];
+                lcdBank[bank][cell][half] = lcdStaged[cell][half];
+                lcdBytesWritten++;
             }
             else
             {
-                LCD_showChar( div[i] + '0', i + 1 );
-                LeadingZeros++;
+                lcdBytesSaved++;
             }
         }
+    }
+    lcdDirty[bank] = 0;
+}
+
+// Writes the two LCDMEM bytes of a character directly into the bank on the
+// glass. This relies on the 4-mux setting in initParams; LCD_C_setMemory
+// would re-read the mux rate and read-modify-write one nibble per pin
+void LCD_showChar(char c, int Position)
+{
+    volatile uint8_t *memory;
+    const char *glyph;
+    uint8_t front;
 
-        i = LCD_NUM_CHAR - 1;
-        LCD_showChar( div[i] + '0', i + 1 );
+    PROFILE_START( PROBE_LCD_SHOW_CHAR );
+    Position -= 1;
+    if ( ( Position >= 0 ) && ( Position < LCD_NUM_CHAR ) )
+    {
+        glyph = lookupGlyph( c );
+        front = frontBank();
+        memory = bankMemory( front );
+
+        memory[ CharMemory[Position][0] ] = glyph[0];
+        memory[ CharMemory[Position][1] ] = glyph[1];
+
+        // Keep the shadow in step with what is on the glass
+        lcdStaged[Position][0] = lcdBank[front][Position][0] = glyph[0];
+        lcdStaged[Position][1] = lcdBank[front][Position][1] = glyph[1];
+        markCell( 0, Position );
+        markCell( 1, Position );
+    }
+    PROFILE_STOP( PROBE_LCD_SHOW_CHAR );
+}
+
+// Stages a character for the next LCD_commit without touching LCDMEM
+void LCD_setCell(char c, int Position)
+{
+    const char *glyph;
+
+    Position -= 1;
+    if ( ( Position >= 0 ) && ( Position < LCD_NUM_CHAR ) )
+    {
+        glyph = lookupGlyph( c );
+        lcdStaged[Position][0] = glyph[0];
+        lcdStaged[Position][1] = glyph[1];
+        markCell( 0, Position );
+        markCell( 1, Position );
+    }
+}
+
+// Stages all LCD_NUM_CHAR cells from segment bytes that are already
+// encoded (messages.c), so a frame of text is a copy with no lookups
+void LCD_setFrame(const char (*cells)[2])
+{
+    int Position;
+
+    for ( Position = 0; Position < LCD_NUM_CHAR; Position++ )
+    {
+        lcdStaged[Position][0] = cells[Position][0];
+        lcdStaged[Position][1] = cells[Position][1];
+        markCell( 0, Position );
+        markCell( 1, Position );
+    }
+}
+
+// Stages a blank screen
+void LCD_clearCells(void)
+{
+    int Position;
+
+    for ( Position = 1; Position <= LCD_NUM_CHAR; Position++ )
+    {
+        LCD_setCell( ' ', Position );
     }
 }
 
+// Shows the staged frame. In double-buffer mode it is written into the
+// hidden bank and appears all at once when LCDDISP flips, so a half
+// updated frame is never on the glass.
+void LCD_commit(void)
+{
+    PROFILE_START( PROBE_LCD_COMMIT );
+    if ( lcdDoubleBuffer && !lcdBlinkHz )
+    {
+        commitBank( !frontBank() );
+        LCDCMEMCTL ^= LCDDISP;
+    }
+    else
+    {
+        commitBank( frontBank() );
+    }
+    PROFILE_STOP( PROBE_LCD_COMMIT );
+}
+
+// Double buffering borrows the blinking memory as the back buffer. While
+// something blinks, frames go straight to LCDMEM instead.
+void LCD_enableDoubleBuffer(void)
+{
+    lcdDoubleBuffer = 1;
+}
+
+// Goes back to showing LCDMEM, with the staged frame on it
+void LCD_disableDoubleBuffer(void)
+{
+    lcdDoubleBuffer = 0;
+    commitBank( 0 );
+    LCD_C_selectDisplayMemory( LCD_C_BASE, LCD_C_DISPLAYSOURCE_MEMORY );
+}
+
+// Empties LCDBMEM and its shadow; the next double-buffered commit writes
+// the whole staged frame into it
+static void clearBlinkingMemory( void )
+{
+    int Position;
+
+    LCD_C_clearBlinkingMemory( LCD_C_BASE );
+    memset( lcdBank[1], 0, sizeof( lcdBank[1] ) );
+    for ( Position = 0; Position < LCD_NUM_CHAR; Position++ )
+    {
+        markCell( 1, Position );
+    }
+}
+
+// Lets LCD_C blink the segments marked with LCD_blinkCell and
+// LCD_blinkSymbol at LCD_BLINK_SLOW, LCD_BLINK_MEDIUM or LCD_BLINK_FAST,
+// with no CPU time. Nothing is marked yet. The frame on the glass moves
+// to LCDMEM, as LCDBMEM now holds the marks.
+void LCD_startBlinking(uint8_t hz)
+{
+    if ( !lcdBlinkHz )
+    {
+        commitBank( 0 );
+        LCD_C_selectDisplayMemory( LCD_C_BASE, LCD_C_DISPLAYSOURCE_MEMORY );
+        clearBlinkingMemory();
+    }
+    lcdBlinkHz = hz;
+    setBlinking( lcdAclk );
+}
+
+// Makes LCDBMEM and its shadow a copy of LCDMEM, symbols included, so
+// either bank can go on the glass
+static void copyMainMemory( void )
+{
+    uint8_t index;
+
+    for ( index = 0; index < LCD_MEMORY_BYTES; index++ )
+    {
+        LCDBMEM[index] = LCDMEM[index];
+    }
+    memcpy( lcdBank[1], lcdBank[0], sizeof( lcdBank[1] ) );
+    lcdDirty[1] = lcdDirty[0];
+}
+
+// Stops all blinking and gives LCDBMEM back to double buffering, holding
+// what is on the glass
+void LCD_stopBlinking(void)
+{
+    lcdBlinkHz = 0;
+    setBlinking( 0 );
+    copyMainMemory();
+}
+
+// Makes a character position (1 to 6) blink or stop blinking, whatever it
+// shows now or later; the symbols sharing its bytes are left alone
+void LCD_blinkCell(int Position, int blink)
+{
+    static const uint8_t cellMask[2] = { 0xFF, ( uint8_t )~CELL_SYMBOL_BITS };
+    uint8_t half;
+    uint8_t index;
+
+    Position -= 1;
+    if ( !lcdBlinkHz || ( Position < 0 ) || ( Position >= LCD_NUM_CHAR ) )
+    {
+        return;
+    }
+    for ( half = 0; half < 2; half++ )
+    {
+        index = CharMemory[Position][half];
+        LCDBMEM[index] = blink ? ( LCDBMEM[index] | cellMask[half] )
+                               : ( LCDBMEM[index] & ~cellMask[half] );
+    }
+}
+
+// Makes a symbol (LCD_HRT, LCD_BATT, ...) blink or stop blinking
+void LCD_blinkSymbol(int Symbol, int blink)
+{
+    if ( lcdBlinkHz )
+    {
+        LCD_showSymbol( blink ? LCD_UPDATE : LCD_CLEAR, Symbol, LCD_MEMORY_BLINKING );
+    }
+}
+
+// LCDMEM bytes written by LCD_commit so far, and bytes it did not have to write
+void LCD_getCommitCounts(uint32_t *written, uint32_t *saved)
+{
+    *written = lcdBytesWritten;
+    *saved = lcdBytesSaved;
+}
+
+// Binary to packed BCD for values up to LCD_NUMBER_MAX. The BCD number is
+// doubled with DADD (__bcd_add_long) for every bit, top bit first, and the
+// bit goes into its lowest digit, which doubling always leaves even. The
+// FR6989 has no divider, so this replaces the 32-bit divisions.
+static uint32_t toBcd( uint32_t value )
+{
+    uint32_t bcd = 0;
+    uint8_t  bit;
+
+    value <<= 32 - LCD_NUMBER_BITS;
+    for ( bit = 0; bit < LCD_NUMBER_BITS; bit++ )
+    {
+        bcd = __bcd_add_long( bcd, bcd ) | ( value >> 31 );
+        value <<= 1;
+    }
+    return bcd;
+}
+
+// Characters of a number on the six positions: right aligned, leading
+// zeros blank, or ERROR if it does not fit
+static void numberText( uint32_t value, char *text )
+{
+    static const char tooBig[ LCD_NUM_CHAR ] = { ' ', 'E', 'R', 'R', 'O', 'R' };
+    uint32_t bcd;
+    int i;
+
+    if ( value > LCD_NUMBER_MAX )
+    {
+        memcpy( text, tooBig, LCD_NUM_CHAR );
+        return;
+    }
+
+    bcd = toBcd( value );
+    for ( i = LCD_NUM_CHAR - 1; i >= 0; i-- )
+    {
+        text[i] = ( bcd || ( i == LCD_NUM_CHAR - 1 ) ) ? '0' + ( bcd & 0x0F ) : ' ';
+        bcd >>= 4;
+    }
+}
+
+// Writes a number straight onto the glass
+void LCD_displayNumber( unsigned long val )
+{
+    char text[ LCD_NUM_CHAR ];
+    int i;
+
+    numberText( val, text );
+    for ( i = 0; i < LCD_NUM_CHAR; i++ )
+    {
+        LCD_showChar( text[i], i + 1 );
+    }
+}
+
+// Stages a number for the next LCD_commit
+void LCD_setNumber( unsigned long val )
+{
+    char text[ LCD_NUM_CHAR ];
+    int i;
+
+    numberText( val, text );
+    for ( i = 0; i < LCD_NUM_CHAR; i++ )
+    {
+        LCD_setCell( text[i], i + 1 );
+    }
+}
+
+// Sets, clears or toggles the bits of a symbol in one byte of LCD memory
+static void changeSymbol( volatile uint8_t *memory, int Operation, int bit )
+{
+    switch ( Operation )
+    {
+    case LCD_UPDATE:
+        *memory |= bit;
+        break;
+    case LCD_CLEAR:
+        *memory &= ~bit;
+        break;
+    case LCD_TOGGLE:
+        *memory ^= bit;
+        break;
+    }
+}
+
+// A symbol on the main memory also goes into LCDBMEM unless that holds the
+// blink marks, so it stays on the glass whichever bank LCD_commit shows
 int LCD_showSymbol( int Operation, int Symbol, int Memory )
 {
     int idx = 0;
@@ -316,17 +666,10 @@ int LCD_showSymbol( int Operation, int Symbol, int Memory )
         break;
     }
 
-    switch ( Operation )
+    changeSymbol( &LCDMEM[ idx - 1 + mem ], Operation, bit );
+    if ( ( Memory == LCD_MEMORY_MAIN ) && !lcdBlinkHz )
     {
-    case LCD_UPDATE:
-        LCDMEM[ idx - 1 + mem ] |= bit;
-        break;
-    case LCD_CLEAR:
-        LCDMEM[ idx - 1 + mem ] &= ~bit;
-        break;
-    case LCD_TOGGLE:
-        LCDMEM[ idx - 1 + mem ] ^= bit;
-        break;
+        changeSymbol( &LCDBMEM[ idx - 1 ], Operation, bit );
     }
 
     if ( ( LCDMEM[ idx - 1 + mem ] & bit ) >> 0 )
@@ -19,7 +19,7 @@
  * ******************************************************************************/
 
 
-#include <msp430fr6989.h>
+#include <msp430.h>
 #include "stdint.h"
 
 #ifndef LCD_DISPLAY_H_
@@ -27,7 +27,19 @@
 
 void LCD_init(void);
 void LCD_showChar( char, int );
+void LCD_setCell( char, int );
+void LCD_setFrame( const char (*)[2] );
+void LCD_clearCells( void );
+void LCD_commit( void );
+void LCD_enableDoubleBuffer( void );
+void LCD_disableDoubleBuffer( void );
+void LCD_getCommitCounts( uint32_t *, uint32_t * );
+void LCD_startBlinking( uint8_t );
+void LCD_stopBlinking( void );
+void LCD_blinkCell( int, int );
+void LCD_blinkSymbol( int, int );
 void LCD_displayNumber( unsigned long );
+void LCD_setNumber( unsigned long );
 int  LCD_showSymbol( int, int, int );
 
 void    LCD_setMemoryBits   ( uint8_t, uint8_t );
@@ -45,6 +57,21 @@ uint8_t LCD_getBlinkingMemoryBits   ( uint8_t          );
 
 #define LCD_NUM_CHAR                6
 
+// Largest number the six positions show, and the bits it takes
+#define LCD_NUMBER_MAX              999999UL
+#define LCD_NUMBER_BITS             20
+
+// Frame rate the LCD_C clock dividers are picked for, and the slowest ACLK
+// that can drive it (a 4-mux frame takes 8 LCD clocks). 256 Hz is what the
+// original divide-by-16 gave from the 32768 Hz crystal.
+#define LCD_FRAME_HZ                256
+#define LCD_CLOCK_MIN_HZ            ( 8UL * LCD_FRAME_HZ )
+
+// Blink rates for LCD_startBlinking, in blinks per second
+#define LCD_BLINK_SLOW              1
+#define LCD_BLINK_MEDIUM            2
+#define LCD_BLINK_FAST              4
+
 #define LCD_HEART_IDX               3
 #define LCD_HEART_SEG               LCD_C_SEGMENT_LINE_4
 #define LCD_HEART_COM               BIT2
@@ -152,8 +179,7 @@ uint8_t LCD_getBlinkingMemoryBits   ( uint8_t          );
 #define LCD_A2COL                   22
 #define LCD_A4COL                   23
 
-extern const char digit[10][2];                                                 // Segment values for each number character
-extern const char alphabetBig[26][2];                                           // Segment values for each alphabet character
+extern const char lcdGlyphs[][2];                                               // Segment values for each 7-bit character and the degree sign (lcdGlyphs.h)
 
 
 #endif
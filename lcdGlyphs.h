@@ -0,0 +1,154 @@
+/******************************************************************************
+ *
+ * FILE: lcdGlyphs.h
+ *
+ * PURPOSE:
+ *   The one definition of what every character looks like on the six
+ *   14-segment positions of the LCD. Each glyph is written as the
+ *   segments it lights; lcdDisplay.c expands the lists below into
+ *   lcdGlyphs, a const table of two-byte entries indexed by the character
+ *   itself, so the compiler builds the table and no code does.
+ *
+ *   Segments of a position (LCDMEM layout, first byte in the low half):
+ *
+ *        ---a---
+ *       |\  |  /|       h j k : upper diagonal, vertical, diagonal
+ *       f h j k b
+ *       |  \|/  |
+ *        -g- -m-
+ *       |  /|\  |
+ *       e q p n c       q p n : lower diagonal, vertical, diagonal
+ *       |/  |  \|
+ *        ---d---
+ *
+ *   Bits 0 and 2 of the second byte belong to symbols (decimal points,
+ *   colons, NEG, DEG), so no glyph uses them.
+ *
+ *   Letters are listed once and fill both cases. Control characters are
+ *   blank, and printable characters the segments cannot draw show
+ *   SEG_ALL. The degree sign has no 7-bit code: it is written as its
+ *   Latin-1 code (LCD_DEGREE_CHAR) and drawn from one extra entry after
+ *   the 7-bit ones. Every other code above 127 is blank.
+ *
+ * CREATED BY:
+ *   Hanna Szalai & Haroun Riahi
+ *
+ ******************************************************************************/
+
+#ifndef LCD_GLYPHS_H_
+#define LCD_GLYPHS_H_
+
+#define SEG_A       0x0080
+#define SEG_B       0x0040
+#define SEG_C       0x0020
+#define SEG_D       0x0010
+#define SEG_E       0x0008
+#define SEG_F       0x0004
+#define SEG_G       0x0002
+#define SEG_M       0x0001
+#define SEG_H       0x8000
+#define SEG_J       0x4000
+#define SEG_K       0x2000
+#define SEG_P       0x1000
+#define SEG_Q       0x0800
+#define SEG_N       0x0200
+
+#define SEG_ALL     ( 0x00FF | SEG_H | SEG_J | SEG_K | SEG_P | SEG_Q | SEG_N )
+
+// Entries of the glyph table: the 7-bit character codes, then the degree sign
+#define LCD_DEGREE_GLYPH    128
+#define LCD_GLYPH_COUNT     129
+
+// Latin-1 degree sign
+#define LCD_DEGREE_CHAR     '\xB0'
+
+// Entry of the glyph table for a character code (0 to 255)
+#define LCD_GLYPH_INDEX( code )                                                 \
+    ( ( code ) < LCD_DEGREE_GLYPH ? ( code )                                    \
+      : ( code ) == ( unsigned char )LCD_DEGREE_CHAR ? LCD_DEGREE_GLYPH : ' ' )
+
+// Upper case letters; the lower case ones get the same glyphs
+#define LCD_LETTER_GLYPHS( X )                                                  \
+    X( 'A', SEG_A | SEG_B | SEG_C | SEG_E | SEG_F | SEG_G | SEG_M )             \
+    X( 'B', SEG_A | SEG_B | SEG_C | SEG_D | SEG_M | SEG_J | SEG_P )             \
+    X( 'C', SEG_A | SEG_D | SEG_E | SEG_F )                                     \
+    X( 'D', SEG_A | SEG_B | SEG_C | SEG_D | SEG_J | SEG_P )                     \
+    X( 'E', SEG_A | SEG_D | SEG_E | SEG_F | SEG_G | SEG_M )                     \
+    X( 'F', SEG_A | SEG_E | SEG_F | SEG_G | SEG_M )                             \
+    X( 'G', SEG_A | SEG_C | SEG_D | SEG_E | SEG_F | SEG_M )                     \
+    X( 'H', SEG_B | SEG_C | SEG_E | SEG_F | SEG_G | SEG_M )                     \
+    X( 'I', SEG_A | SEG_D | SEG_J | SEG_P )                                     \
+    X( 'J', SEG_B | SEG_C | SEG_D | SEG_E )                                     \
+    X( 'K', SEG_E | SEG_F | SEG_G | SEG_K | SEG_N )                             \
+    X( 'L', SEG_D | SEG_E | SEG_F )                                             \
+    X( 'M', SEG_B | SEG_C | SEG_E | SEG_F | SEG_H | SEG_K )                     \
+    X( 'N', SEG_B | SEG_C | SEG_E | SEG_F | SEG_H | SEG_N )                     \
+    X( 'O', SEG_A | SEG_B | SEG_C | SEG_D | SEG_E | SEG_F )                     \
+    X( 'P', SEG_A | SEG_B | SEG_E | SEG_F | SEG_G | SEG_M )                     \
+    X( 'Q', SEG_A | SEG_B | SEG_C | SEG_D | SEG_E | SEG_F | SEG_N )             \
+    X( 'R', SEG_A | SEG_B | SEG_E | SEG_F | SEG_G | SEG_M | SEG_N )             \
+    X( 'S', SEG_A | SEG_C | SEG_D | SEG_F | SEG_G | SEG_M )                     \
+    X( 'T', SEG_A | SEG_J | SEG_P )                                             \
+    X( 'U', SEG_B | SEG_C | SEG_D | SEG_E | SEG_F )                             \
+    X( 'V', SEG_E | SEG_F | SEG_K | SEG_Q )                                     \
+    X( 'W', SEG_B | SEG_C | SEG_E | SEG_F | SEG_Q | SEG_N )                     \
+    X( 'X', SEG_H | SEG_K | SEG_Q | SEG_N )                                     \
+    X( 'Y', SEG_H | SEG_K | SEG_P )                                             \
+    X( 'Z', SEG_A | SEG_D | SEG_K | SEG_Q )
+
+// Everything else that is not blank
+#define LCD_OTHER_GLYPHS( X )                                                   \
+    X( '0', SEG_A | SEG_B | SEG_C | SEG_D | SEG_E | SEG_F | SEG_K | SEG_Q )     \
+    X( '1', SEG_B | SEG_C | SEG_K )                                             \
+    X( '2', SEG_A | SEG_B | SEG_D | SEG_E | SEG_G | SEG_M )                     \
+    X( '3', SEG_A | SEG_B | SEG_C | SEG_D | SEG_G | SEG_M )                     \
+    X( '4', SEG_B | SEG_C | SEG_F | SEG_G | SEG_M )                             \
+    X( '5', SEG_A | SEG_C | SEG_D | SEG_F | SEG_G | SEG_M )                     \
+    X( '6', SEG_A | SEG_C | SEG_D | SEG_E | SEG_F | SEG_G | SEG_M )             \
+    X( '7', SEG_A | SEG_B | SEG_C | SEG_F )                                     \
+    X( '8', SEG_A | SEG_B | SEG_C | SEG_D | SEG_E | SEG_F | SEG_G | SEG_M )     \
+    X( '9', SEG_A | SEG_B | SEG_C | SEG_D | SEG_F | SEG_G | SEG_M )             \
+    X( '!', SEG_B | SEG_C )                                                     \
+    X( '"', SEG_F | SEG_J )                                                     \
+    X( '#', SEG_B | SEG_C | SEG_D | SEG_G | SEG_M | SEG_J | SEG_P )             \
+    X( '$', SEG_A | SEG_C | SEG_D | SEG_F | SEG_G | SEG_M | SEG_J | SEG_P )     \
+    X( '%', SEG_C | SEG_F | SEG_K | SEG_Q )                                     \
+    X( '&', SEG_A | SEG_D | SEG_E | SEG_G | SEG_H | SEG_J | SEG_N )             \
+    X( '\'', SEG_K )                                                            \
+    X( '(', SEG_K | SEG_N )                                                     \
+    X( ')', SEG_H | SEG_Q )                                                     \
+    X( '*', SEG_G | SEG_M | SEG_H | SEG_J | SEG_K | SEG_Q | SEG_P | SEG_N )     \
+    X( '+', SEG_G | SEG_M | SEG_J | SEG_P )                                     \
+    X( ',', SEG_Q )                                                             \
+    X( '-', SEG_G | SEG_M )                                                     \
+    X( '.', SEG_N )                                                             \
+    X( '/', SEG_K | SEG_Q )                                                     \
+    X( ':', SEG_J | SEG_P )                                                     \
+    X( ';', SEG_J | SEG_Q )                                                     \
+    X( '<', SEG_K | SEG_N )                                                     \
+    X( '=', SEG_D | SEG_G | SEG_M )                                             \
+    X( '>', SEG_H | SEG_Q )                                                     \
+    X( '?', SEG_A | SEG_B | SEG_M | SEG_P )                                     \
+    X( '@', SEG_A | SEG_B | SEG_D | SEG_E | SEG_F | SEG_J | SEG_M )             \
+    X( '[', SEG_A | SEG_D | SEG_E | SEG_F )                                     \
+    X( '\\', SEG_H | SEG_N )                                                    \
+    X( ']', SEG_A | SEG_B | SEG_C | SEG_D )                                     \
+    X( '^', SEG_Q | SEG_N )                                                     \
+    X( '_', SEG_D )                                                             \
+    X( '`', SEG_H )                                                             \
+    X( '{', SEG_A | SEG_D | SEG_G | SEG_H | SEG_Q )                             \
+    X( '|', SEG_J | SEG_P )                                                     \
+    X( '}', SEG_A | SEG_D | SEG_M | SEG_K | SEG_N )                             \
+    X( '~', SEG_ALL )                                                           \
+    X( LCD_DEGREE_GLYPH, SEG_A | SEG_B | SEG_F | SEG_G | SEG_M )
+
+// Initializer of a char [LCD_GLYPH_COUNT][2] table with every glyph above,
+// for lcdDisplay.c and the host tools that pre-encode text
+#define LCD_GLYPH_ENTRY( c, segments )                                          \
+    [ c ] = { ( char )( ( segments ) & 0xFF ), ( char )( ( segments ) >> 8 ) },
+#define LCD_LETTER_ENTRY( c, segments )                                         \
+    LCD_GLYPH_ENTRY( c, segments ) LCD_GLYPH_ENTRY( ( c ) - 'A' + 'a', segments )
+#define LCD_GLYPH_TABLE                                                         \
+    LCD_LETTER_GLYPHS( LCD_LETTER_ENTRY ) LCD_OTHER_GLYPHS( LCD_GLYPH_ENTRY )
+
+#endif
@@ -139,6 +139,11 @@ SECTIONS
            .sysmem        : {}              /* Dynamic memory allocation area    */
         } PALIGN(0x0400), RUN_START(fram_rw_start)
 
+        GROUP(SCORE_MEMORY)
+        {
+           .scores        : type = NOINIT{} /* High scores, MPU write-protected  */
+        } PALIGN(0x0400), RUN_START(fram_scores_start)
+
         GROUP(IPENCAPSULATED_MEMORY)
         {
            .ipestruct     : {}              /* IPE Data structure                */
@@ -318,7 +323,10 @@ SECTIONS
          mpu_segment_border2 = fram_rx_start >> 4;
          mpu_sam_value = 0x1573; // Info R, Seg3 RX, Seg2 RWX, Seg1 RW
       #else
-         mpu_segment_border1 = fram_rx_start >> 4;
+         //seg1 = any read + write persistent variables
+         //seg2 = scores = read only, written in scoreStore.c write windows
+         //seg3 = code, read + execute only
+         mpu_segment_border1 = fram_scores_start >> 4;
          mpu_segment_border2 = fram_rx_start >> 4;
          mpu_sam_value = 0x1513; // Info R, Seg3 RX, Seg2 R, Seg1 RW
       #endif
@@ -12,7 +12,8 @@
  *
  *   The game generates a randomized sequence of red and green LED flashes
  *   which the player must reproduce by pressing the corresponding buttons.
- *   The sequence grows longer with each successful round. If the player
+ *   The sequence grows longer with each successful round, up to
+ *   SEQUENCE_MAX_STEPS rounds. If the player
  *   makes a mistake or completes all rounds, a Game Over or You Win message
  *   is displayed.
  *
@@ -30,21 +31,20 @@
 #include <string.h>
 #include <lcdDisplay.h>
 #include <gpioSetup.h>
+#include <scheduler.h>
+#include <buttons.h>
+#include <sequence.h>
+#include <uart.h>
+#include <telemetry.h>
+#include <reactionTimer.h>
+#include <profiler.h>
+#include <scoreStore.h>
+#include <checkpoint.h>
+#include <messages.h>
+#include <playback.h>
+#include <difficulty.h>
 #include <msp430.h>
 
-// RED LED
-#define RED_ON  0x0001
-#define RED_OFF   0xFFFE
-
-// GREEN LED
-#define GREEN_ON  0x0080
-#define GREEN_OFF 0xFF7F
-
-
-// BUTTONS
-#define BUTTON_ONE   0x0002
-#define BUTTON_TWO  0x0004
-
 // TIMERS
 #define TIMER_UP_MODE   0x0010
 #define TIMER_CONTINUOUS  0x0020
@@ -53,73 +53,84 @@
 
 #define ENABLE_PINS  0xFFFE
 #define BUTTON_DELAY    0xA000
-#define TEN_MS_COUNT  100
 #define TIMER_SMCLK_SRC   0x0200
 
-void uart_init(void) {
-    // Unlock GPIO configuration
-    PM5CTL0 &= ~LOCKLPM5;
-
-    // Configure UART pins P3.4 (TX) and P3.5 (RX)
-    P3SEL0 |= BIT4 | BIT5;
-    P3SEL1 &= ~(BIT4 | BIT5);
-
-    // Configure clock system - using DCO at 8MHz
-    CSCTL0_H = CSKEY >> 8;        // Unlock clock registers
-    CSCTL1 = DCOFSEL_3 | DCORSEL; // Set DCO to 8MHz
-    CSCTL2 = SELA__VLOCLK | SELS__DCOCLK | SELM__DCOCLK;
-    CSCTL3 = DIVA__1 | DIVS__1 | DIVM__1;
-    CSCTL0_H = 0;                 // Lock clock registers
-
-    // Configure UART
-    UCA1CTLW0 = UCSWRST;          // Put eUSCI in reset
-    UCA1CTLW0 |= UCSSEL__SMCLK;   // Use SMCLK (8MHz)
-
-    // Baud rate calculation for 9600 baud:
-    UCA1BR0 = 52;                 // 8000000/9600/16 = 52.083
-    UCA1BR1 = 0x00;
-    UCA1MCTLW = UCOS16 | UCBRF_1 | 0x4900;  // UCBRFx=1, UCBRSx=0x49
-
-    // Clear reset to initialize UART
-    UCA1CTLW0 &= ~UCSWRST;
-
-    // Add delay to ensure UART is ready
+// Prints the pace the game ended at and the CPU-active time of every game
+// phase so they can be logged on the host
+void reportPhaseTimes(void)
+{
+    static const char * const phaseNames[PHASE_COUNT] =
+    {
+        "INTRO", "BANNER", "PLAYBACK", "INPUT", "GAMEOVER"
+    };
+    uint8_t phase;
+
+    uartPrint("PACE ");
+    uartPrintNumber(difficultyPacePercent());
+    uartPrint("%\r\n");
+    uartPrint("ACTIVE SMCLK CYCLES\r\n");
+    for (phase = 0; phase < PHASE_COUNT; phase++)
+    {
+        uartPrint(phaseNames[phase]);
+        uartPrint(" ");
+        uartPrintNumber(phaseActiveTicks[phase]);
+        uartPrint("\r\n");
+    }
 }
 
-void uartPrint(const char* str) {
-    while (*str) {
-        // Wait until TX buffer is ready
-        while (!(UCA1IFG & UCTXIFG));
-
-        // Send character
-        UCA1TXBUF = *str++;
+// Prints how many LCDMEM bytes the shadow framebuffer wrote and how many it saved
+void reportLcdWrites(void)
+{
+    uint32_t written;
+    uint32_t saved;
+
+    LCD_getCommitCounts(&written, &saved);
+    uartPrint("LCD BYTES WRITTEN ");
+    uartPrintNumber(written);
+    uartPrint(" SAVED ");
+    uartPrintNumber(saved);
+    uartPrint("\r\n");
+}
 
+// Prints the games played and the high-score table kept in FRAM, then
+// sends the whole store as a telemetry frame for the host to keep
+void reportScores(void)
+{
+    uint8_t rank;
 
+    uartPrint("GAMES ");
+    uartPrintNumber(scoreGamesPlayed());
+    uartPrint(" HIGH SCORES");
+    for (rank = 0; rank < SCORE_TABLE_SIZE; rank++)
+    {
+        uartPrint(" ");
+        uartPrintNumber(scoreHighScore(rank));
     }
-
-    // Ensure last character is transmitted
-    while (!(UCA1IFG & UCTXIFG));
+    uartPrint("\r\n");
+    scoreSendStore();
 }
 
-
 void main (void)
 {
-    void scrollText(char msg[250]);
-    void showText(char msg[250]);
+    void scrollText(uint8_t message);
+    void showText(uint8_t message);
     void showNumber(unsigned long int number);
     void showMultiWords(char msg[250]);
-    int  delay(int count);
     int  generateRandomPattern(int pattern);
-    void playSequence(int pattern, int i);
-    int  getUserInput(int pattern, int gameOver, int i);
+    void playSequence(int i);
+    int  getUserInput(int gameOver, int i);
     void displayGameOver(int points);
+    void reportPhaseTimes(void);
+    void reportLcdWrites(void);
+    void reportScores(void);
 
     // Game state variables
     int round;
     int points;
     int pattern;
     int gameOver;
-    int delayCount;
+    int firstRound;
+    GameCheckpoint checkpoint;
 
     // Disable watchdog timer
     WDTCTL = WDTPW | WDTHOLD;
@@ -128,6 +139,7 @@ void main (void)
     initializePins();
     initializeClocks();
     LCD_init();
+    LCD_enableDoubleBuffer();
     PM5CTL0 = ENABLE_PINS;
 
     uart_init();
@@ -138,50 +150,102 @@ void main (void)
     TA0CTL   = TA0CTL | (TIMER_SMCLK_SRC + TIMER_CONTINUOUS);
     TA0CCTL0 = CCIE;
 
-    // Set up Timer A1 for up mode using ACLK
-    TA1CTL   = TA1CTL | (TIMER_ACLK_SRC  + TIMER_UP_MODE         );
-    TA1CCR0  = TEN_MS_COUNT;
+    // Set up Timer A1 as the 10 ms scheduler tick using ACLK
+    initializeScheduler();
+
+    // Timer_B0 times the button edges the port 1 interrupt captures
+    initializeReactionTimer();
+
+    // Button presses arrive as debounced events from the port 1 interrupt
+    initializeButtons();
+
+    // A peripheral whose clock is too slow for it still runs, but off time
+    if (clockShortfall())
+    {
+        uartPrint("CLOCK TOO SLOW\r\n");
+    }
 
     // Enable interrupts globally
     _BIS_SR(GIE);
 
+    // Scores of earlier games are kept in write-protected FRAM
+    initializeScoreStore();
+    reportScores();
+
     while(1)
     {
         // Reset state at beginning of game
         gameOver = 0;
         pattern = 0;
         points    = 0;
+        firstRound = 0;
+        resetPhaseTimes();
+        PROFILE_RESET();
+        difficultyNewGame();
+        setGamePhase(PHASE_INTRO);
+
+        // A game whose score went in just before a reset is over; only its
+        // checkpoint was left to clear
+        if (checkpointLoad(&checkpoint) && scoreGameRecorded(checkpointSequence()))
+        {
+            checkpointClear();
+        }
 
-        // Show initial LEDs and wait for user to start
-        P1OUT = P1OUT | RED_ON;
-        P9OUT = P9OUT | GREEN_ON;
-        scrollText("BEGIN BY PRESSING S1");
+        if (checkpointLoad(&checkpoint))
+        {
+            // A reset cut the last game short: go on from the round it was in
+            pattern    = checkpoint.seed;
+            firstRound = checkpoint.round;
+            points     = checkpoint.points;
+            difficultyRestorePace(checkpoint.pace);
+            uartPrint("RESUMING GAME\r\n");
+        }
+        else
+        {
+            // Show initial LEDs and wait for user to start
+            P1OUT = P1OUT | RED_ON;
+            P9OUT = P9OUT | GREEN_ON;
+            scrollText(MSG_BEGIN);
 
-        // Generate RANDOM game sequence
-        pattern = generateRandomPattern(pattern);
+            // Seed the RANDOM game sequence
+            pattern = generateRandomPattern(pattern);
+        }
+        startSequence(pattern);
 
         // Begin main gameplay loop
         while(!gameOver)
         {
-            for(round=0; round<16; round=round+1)
+            for(round=firstRound; round<SEQUENCE_MAX_STEPS; round=round+1)
             {
                 P1OUT = P1OUT & RED_OFF;
                 P9OUT = P9OUT & GREEN_OFF;
-                delayCount = 30;
-                while(delayCount = delay(delayCount));
+                setGamePhase(PHASE_BANNER);
+                waitTicks(difficultyBannerTicks(round));
 
                 if(!gameOver)
                 {
-                    showText("LEVEL");
-                    delayCount = 30;
-                    while(delayCount = delay(delayCount));
+                    // Checkpoint every round, so a reset comes back to it
+                    checkpoint.seed   = pattern;
+                    checkpoint.round  = round;
+                    checkpoint.points = points;
+                    checkpoint.pace   = difficultyPace();
+                    checkpointSave(&checkpoint);
+
+                    showText(MSG_LEVEL);
+                    waitTicks(difficultyBannerTicks(round));
                     showNumber(round+1);
-                    delayCount = 30;
-                    while(delayCount = delay(delayCount));
+                    waitTicks(difficultyBannerTicks(round));
 
                     // Show and evaluate input
-                    playSequence(pattern,round);
-                    gameOver = getUserInput(pattern,gameOver,round);
+                    setGamePhase(PHASE_PLAYBACK);
+                    extendSequence(round+1);
+                    telemetryRoundStart(round);
+                    playSequence(round);
+                    setGamePhase(PHASE_INPUT);
+                    gameOver = getUserInput(gameOver,round);
+
+                    // Speed up or slow down for the player's reactions and mistakes
+                    difficultyRoundEnd(gameOver);
 
                     if(!gameOver)
                     {
@@ -197,7 +261,17 @@ void main (void)
 
         }
         // Show game over screen
+        setGamePhase(PHASE_GAMEOVER);
+        // Recorded before the checkpoint goes, so a reset in between
+        // cannot lose the finished game's score; the checkpoint number
+        // keeps it from being counted twice
+        scoreRecordGame(points, checkpointSequence());
+        checkpointClear();
         displayGameOver(points);
+        setGamePhase(PHASE_INTRO);
+        reportPhaseTimes();
+        reportLcdWrites();
+        reportScores();
     }
 }
 
@@ -208,143 +282,66 @@ __interrupt void Timer_A0 (void)
     TA0CTL = TA0CTL & (~TAIFG);
 }
 
-// Clears the LCD screen by writing empty spaces (' ') to all 6 visible positions.
+// Blanks all 6 LCD positions in the shadow; the screen changes at the next LCD_commit.
 void clearDisplay(void)
 {
-    int positionIndex = 1;
-    // Go through each of the 6 LCD slots and set them to ' ' (a blank space)
-    while (positionIndex <= 6)
-    {
-        LCD_showChar(' ', positionIndex);
-        positionIndex++;
-    }
+    PROFILE_START(PROBE_CLEAR_DISPLAY);
+    LCD_clearCells();
+    PROFILE_STOP(PROBE_CLEAR_DISPLAY);
 }
 
 // This function scrolls a message across the 6-character LCD screen one letter at a time.
-void scrollText(char msg[250])
+void scrollText(uint8_t message)
 {
     // These are helper functions we use inside this function.
     void clearDisplay(void);
-    int delay(int count);
 
-    // Finding out how long the message is
-    unsigned int msgLen = strlen(msg);
+    // The message is already in segment bytes, with blanks on both sides
+    const Message *text = &messages[message];
     // This keeps track of how far we've shifted the message
-    unsigned int shiftPos = 0;
-
-    unsigned int lcdPos, msgPos;
-    char currentChar;
-    int wait;
+    uint16_t shiftPos;
 
     // Clear the screen so there's nothing showing
     clearDisplay();
+    LCD_commit();
 
     // Keep moving the message until the entire string has scrolled off the screen
-    while (shiftPos < msgLen + 6)
+    for (shiftPos = 0; shiftPos < text->length + LCD_NUM_CHAR; shiftPos++)
     {
-        // Start scrolling from this position in the message
-        msgPos = shiftPos;
+        PROFILE_START(PROBE_SCROLL_FRAME);
 
-        for (lcdPos = 1; lcdPos <= 6; lcdPos++)
-        {
-            if (msgPos >= 6 && msgPos < msgLen + 6)
-            {
-                // Display the character at the current LCD position
-                currentChar = msg[msgPos - 6];
-                LCD_showChar(currentChar, lcdPos);
-            }
-            else
-            {
-                // If there's nothing left to show, just put a blank space
-                LCD_showChar(' ', lcdPos);
-            }
-            msgPos++;
-        }
+        // The frame is the six cells from the scroll position
+        LCD_setFrame(&text->cells[shiftPos]);
+
+        // Show the frame; only the positions that changed are written
+        LCD_commit();
+        PROFILE_STOP(PROBE_SCROLL_FRAME);
 
         // Wait a bit so the message scrolls slowly and is readable
-        wait = 20; // 20 x 10ms = 200ms delay
-        while (wait = delay(wait));
-        // Move the scroll one character to the left
-        shiftPos++;
+        waitTicks(20); // 20 x 10ms = 200ms delay
     }
     // Clear screen again after message has fully scrolled off
     clearDisplay();
+    LCD_commit();
 }
 
 
 // Displays a short word (6 characters max) directly on the LCD screen.
-void showText(char msg[250])
+void showText(uint8_t message)
 {
-    // Function to clear the LCD
-void clearDisplay(void);
-
-unsigned int i;
-unsigned int msgLength;
-char currentChar;
-
-clearDisplay();
-
-// Measure how long the message is
-msgLength = strlen(msg);
-
-if (msgLength <= 6)
-{
-    // Loop through the message and show each character
-    for (i = 0; i < msgLength; i++)
-    {
-        currentChar = msg[i];         // Get the character from the message
-        LCD_showChar(currentChar, i + 1);  // Display it at position 1-6
-    }
-}
+    // The word starts after the blanks on its left and the ones on its
+    // right fill the rest of the screen
+    LCD_setFrame(&messages[message].cells[LCD_NUM_CHAR]);
+    LCD_commit();
 }
 
 // This is how we are showing numbers on the levels
 void showNumber(unsigned long int value)
 {
-    // Function to clear all characters from the LC
-    void clearDisplay(void);
-
-    unsigned long int currentDigit;
-    int pos;
-    long int divisor  = 10000;
-    long int divisorNext  = 100000;
-    int skipLeadingZeros  = 1;
-
-    // Start with a blank screen
-    clearDisplay();
-
-    // Special case: if the number is 0, just show '0' on the far right
-    if (value == 0)
-    {
-        // Display '0' in the 6th (last) position
-        LCD_showChar('0', 6);
-    }
-    else
-    {
-        // Loop through each LCD digit position from left to right (1 to 6)
-        for (pos = 1; pos <= 6; pos++)
-        {
-            if (pos == 1)
-            {
-                // For the first digit (leftmost), extract the hundred-thousands place
-                currentDigit = (value / 100000) + '0';
-            }
-            else
-            {
-                // Extract the next digit using division and modulo logic
-                currentDigit = (value / divisor) - ((value / divisorNext) * 10) + '0';
-                divisor /= 10;
-                divisorNext /= 10;
-            }
-
-            // Skip printing leading zeros
-            if (!((currentDigit == '0') && (skipLeadingZeros == 1)))
-            {
-                skipLeadingZeros = 0;
-                LCD_showChar(currentDigit, pos);
-            }
-        }
-    }
+    // Right aligned without leading zeros, converted to BCD with no
+    // division (the MSP430 has no divider)
+    LCD_setNumber(value);
+    LCD_commit();
 }
 
 
@@ -352,11 +349,9 @@ void showNumber(unsigned long int value)
 void showMultiWords(char msg[250])
 {
     void clearDisplay(void);
-    int delay(int count);
 
     unsigned int i = 0;  // Index in the message string
     unsigned int lcdPos = 1; // Position on the LCD (1 to 6)
-    unsigned int delayCount;
     char ch;
 
     clearDisplay();
@@ -371,14 +366,15 @@ void showMultiWords(char msg[250])
         while (msg[i] != ' ' && msg[i] != '\0' && lcdPos <= 6)
         {
             ch = msg[i++];
-            LCD_showChar(ch, lcdPos++);
+            LCD_setCell(ch, lcdPos++);
         }
+        LCD_commit();
 
         // Wait after displaying the word
-        delayCount = 30;                // ~400ms delay between words
-        while ((delayCount = delay(delayCount)));
+        waitTicks(30);                // ~400ms delay between words
 
         clearDisplay();
+        LCD_commit();
 
         // If space was found, skip over it to get to the next word
         if (msg[i] == ' ')
@@ -386,143 +382,155 @@ void showMultiWords(char msg[250])
     }
 
     // Final delay and cleanup
-    delayCount = 30;
-    while ((delayCount = delay(delayCount)));
+    waitTicks(30);
     clearDisplay();
-}
-
-int delay(int count)
-{
-    if (TA1CTL & TAIFG)
-    {
-        // Reduce remaining wait cycles
-        count--;
-        // Acknowledge and clear overflow flag
-        TA1CTL &= ~TAIFG;
-    }
-
-    return count;
+    LCD_commit();
 }
 
 // Generates a pseudo-random 16-bit seed based on timer value and user input
 int generateRandomPattern(int pattern)
 {
+    // Only count presses made after the intro message
+    flushButtonEvents();
+
     while(!pattern)
     {
-        if(!(P1IN & BUTTON_ONE))
+        if(waitButtonEvent() == BUTTON_ONE)
         {
-            pattern = TA0R;
+            // Timer_A0 stops while we sleep, so mix in the tick count too
+            pattern = TA0R ^ (int)tickCount;
         }
     }
     return pattern;
 }
 
 // Plays a sequence of LED flashes for the user to observe.
-void playSequence(int pattern, int round)
+void playSequence(int round)
 {
-    int delay(int count);
-    void showText(char msg[250]);
+    void showText(uint8_t message);
 
-    int ledBit = 0;       // Current bit from the pattern
+    int ledBit = 0;       // Current step from the sequence
     int step = 0;         // Step through the sequence
-    int wait = 0;
+    uint32_t shownTick;   // Tick the LED of the step lights at
+    uint16_t onTicks = difficultyOnTicks(round);
+    uint16_t gapTicks = difficultyGapTicks(round);
+    SequenceCursor cursor;
 
+    showText(MSG_WATCH);
+    startCursor(&cursor);
+
+    // The round becomes a list of LED events that the scheduler tick
+    // plays while we sleep; a round longer than the queue is added as it plays
+    playbackStart();
     while (step <= round)
     {
-        showText("WATCH");
+        PROFILE_START(PROBE_PLAYBACK_STEP);
+        ledBit = readCursor(&cursor);
 
-        wait = 25;
-        while ((wait = delay(wait)));  // Short pause before LED
+        // Short pause with the LEDs off, then the LED of the step
+        shownTick = playbackQueue(gapTicks, (ledBit == STEP_RED) ? PLAYBACK_LED_RED : PLAYBACK_LED_GREEN);
+        telemetryPlayback(round, step, ledBit, shownTick * (1000 / TICK_HZ));
 
-        ledBit = (pattern >> step) & 0x01;
-
-        if (ledBit == 0)
-        {
-            P1OUT |= RED_ON;        // Red LED ON
-            P9OUT &= GREEN_OFF;     // Green LED OFF
-        }
-        else
-        {
-            P9OUT |= GREEN_ON;      // Green LED ON
-            P1OUT &= RED_OFF;       // Red LED OFF
-        }
-
-        wait = 25;
-        while ((wait = delay(wait)));  // Hold LED state
-
-        P1OUT &= RED_OFF;           // Turn off red LED
-        P9OUT &= GREEN_OFF;         // Turn off green LED
+        // Hold the LED, then turn it off
+        playbackQueue(onTicks, PLAYBACK_LEDS_OFF);
 
+        advanceCursor(&cursor);
         step++;                     // Move to next step in pattern
+        PROFILE_STOP(PROBE_PLAYBACK_STEP);
     }
+    playbackFinish();
+    waitPlayback();
+
+    // Reaction times of this round count from here
+    reactionStartRound();
 }
 
 
 // This function waits for the player to replicate the LED pattern by pressing the correct buttons.
-int getUserInput(int pattern, int gameOver, int round)
+int getUserInput(int gameOver, int round)
 {
-    void showText(char msg[250]);
-    int delay(int count);
+    void showText(uint8_t message);
 
     int btnPressCount = 0;    // How many button presses the user has made
-    int delayCount;
     int expectedBit;
+    uint8_t event;
+    uint32_t pressMs = 0;     // When the button being released went down
+    SequenceCursor cursor;
+
+    // "GO" blinks by itself while the CPU sleeps between presses
+    showText(MSG_GO);
+    LCD_startBlinking(LCD_BLINK_FAST);
+    LCD_blinkCell(1, 1);
+    LCD_blinkCell(2, 1);
+    startCursor(&cursor);
 
-    showText("GO");
+    // Presses made while the pattern was playing do not count
+    flushButtonEvents();
 
     // Loop until all button presses are received or user makes a mistake
     while ((btnPressCount <= round) && !gameOver)
     {
-        // --- Check if Button 1 (S1) is pressed ---
-        if ((BUTTON_ONE & P1IN) == 0)
+        // Sleep until a debounced press or release arrives
+        event = waitButtonEvent();
+        PROFILE_START(PROBE_INPUT_EVENT);
+
+        switch (event)
         {
-            // Wait until the button is released (debouncing)
-            while ((BUTTON_ONE & P1IN) == 0)
-            {
-                P1OUT |= RED_ON;          // Light red LED to confirm press
-                delayCount = 3;           // Short delay (30ms)
-                while ((delayCount = delay(delayCount)));
-            }
+        case BUTTON_ONE:
+            P1OUT |= RED_ON;              // Light red LED to confirm press
+            pressMs = telemetryTimeOf(getButtonEventTime());
+            reactionRecordPress(getButtonEventTime());
+            break;
+
+        case BUTTON_TWO:
+            P9OUT |= GREEN_ON;            // Light green LED to confirm press
+            pressMs = telemetryTimeOf(getButtonEventTime());
+            reactionRecordPress(getButtonEventTime());
+            break;
+
+        // --- Button 1 (S1) released ---
+        case BUTTON_ONE | BUTTON_EVENT_RELEASED:
             P1OUT &= RED_OFF;            // Turn off red LED
+            reactionRecordRelease(getButtonEventTime());
 
-            // Get the expected bit from the pattern
-            expectedBit = (pattern >> btnPressCount) & 0x01;
+            // Get the expected step from the sequence
+            expectedBit = readCursor(&cursor);
+            telemetryPress(round, btnPressCount, STEP_RED, expectedBit == STEP_RED, pressMs);
 
-            // If expected bit is not 0, player made a mistake
-            if (expectedBit != 0)
+            // If expected step is not red, player made a mistake
+            if (expectedBit != STEP_RED)
             {
                 gameOver = 1;         // Set game over flag
-                break;                  // Exit input loop
+                break;
             }
 
+            advanceCursor(&cursor);
             btnPressCount++;         // Move to next expected input
-        }
+            break;
 
-        // --- Check if Button 2 (S2) is pressed ---
-        else if ((BUTTON_TWO & P1IN) == 0)
-        {
-            // Wait until the button is released (debouncing)
-            while ((BUTTON_TWO & P1IN) == 0)
-            {
-                P9OUT |= GREEN_ON;        // Light green LED to confirm press
-                delayCount = 3;         // Short delay (30ms)
-                while ((delayCount = delay(delayCount)));
-            }
+        // --- Button 2 (S2) released ---
+        case BUTTON_TWO | BUTTON_EVENT_RELEASED:
             P9OUT &= GREEN_OFF;        // Turn off green LED
+            reactionRecordRelease(getButtonEventTime());
 
-            // Get the expected bit from the pattern
-            expectedBit = (pattern >> btnPressCount) & 0x01;
+            // Get the expected step from the sequence
+            expectedBit = readCursor(&cursor);
+            telemetryPress(round, btnPressCount, STEP_GREEN, expectedBit == STEP_GREEN, pressMs);
 
-            // If expected bit is not 1, player made a mistake
-            if (expectedBit == 0)
+            // If expected step is not green, player made a mistake
+            if (expectedBit != STEP_GREEN)
             {
                 gameOver = 1;            // Set game over flag
-                break;                     // Exit input loop
+                break;
             }
 
+            advanceCursor(&cursor);
             btnPressCount++;         // Move to next expected input
+            break;
         }
+        PROFILE_STOP(PROBE_INPUT_EVENT);
     }
+    LCD_stopBlinking();
 
     return gameOver; // Return 1 if player lost, 0 if they got the pattern right
 }
@@ -531,26 +539,43 @@ int getUserInput(int pattern, int gameOver, int round)
 // This function handles the game over screen
 void displayGameOver(int points)
 {
-    void scrollText(char msg[250]);
+    void scrollText(uint8_t message);
     void showNumber(unsigned long int number);
 
-    // Check if the player won (got all 16 correct)
-    if (points == 16)
+    int position;
+    uint8_t event;
+
+    telemetryResult(points, points == SEQUENCE_MAX_STEPS);
+
+    // Check if the player won (got the whole sequence correct)
+    if (points == SEQUENCE_MAX_STEPS)
     {
-        scrollText("YOU WIN");
+        scrollText(MSG_YOU_WIN);
     }
     else
     {
-        scrollText("GAME OVER FINAL SCORE");
+        scrollText(MSG_GAME_OVER);
         showNumber(points);
+
+        // The final score blinks until the next game, with no CPU time
+        LCD_startBlinking(LCD_BLINK_SLOW);
+        for (position = 1; position <= LCD_NUM_CHAR; position++)
+        {
+            LCD_blinkCell(position, 1);
+        }
     }
 
-    // Wait for player to press both buttons (S1 and S2) to restart the game
-    while (1)
+    // Wait for player to press both buttons (S1 and S2) to restart the game.
+    // Tapping S1 on its own prints the profile of the game (PROFILING builds);
+    // the release of the last press of the game does not count.
+    flushButtonEvents();
+    while (getHeldButtons() != (BUTTON_ONE | BUTTON_TWO))
     {
-        if (!(BUTTON_ONE & P1IN) && !(BUTTON_TWO & P1IN))
+        event = waitButtonEvent();  // Sleep until one of the buttons changes
+        if (event == (BUTTON_ONE | BUTTON_EVENT_RELEASED) && !getHeldButtons())
         {
-            break;  // Exit when both buttons are held
+            PROFILE_DUMP();
         }
     }
+    LCD_stopBlinking();
 }
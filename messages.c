@@ -0,0 +1,187 @@
+/******************************************************************************
+ *
+ * FILE: messages.c
+ *
+ * DESCRIPTION:
+ *   The texts of messages.h as LCD segment bytes.
+ *   Generated by host/messageGen.c from messages.h and lcdGlyphs.h;
+ *   do not edit, regenerate it instead.
+ *
+ * CREATED BY:
+ *   Hanna Szalai & Haroun Riahi
+ *
+ ******************************************************************************/
+
+#include "messages.h"
+
+// "BEGIN BY PRESSING S1"
+static const char cellsBegin[32][2] =
+{
+    { 0x00, 0x00 },  /* ' ' */
+    { 0x00, 0x00 },  /* ' ' */
+    { 0x00, 0x00 },  /* ' ' */
+    { 0x00, 0x00 },  /* ' ' */
+    { 0x00, 0x00 },  /* ' ' */
+    { 0x00, 0x00 },  /* ' ' */
+    { 0xF1, 0x50 },  /* 'B' */
+    { 0x9F, 0x00 },  /* 'E' */
+    { 0xBD, 0x00 },  /* 'G' */
+    { 0x90, 0x50 },  /* 'I' */
+    { 0x6C, 0x82 },  /* 'N' */
+    { 0x00, 0x00 },  /* ' ' */
+    { 0xF1, 0x50 },  /* 'B' */
+    { 0x00, 0xB0 },  /* 'Y' */
+    { 0x00, 0x00 },  /* ' ' */
+    { 0xCF, 0x00 },  /* 'P' */
+    { 0xCF, 0x02 },  /* 'R' */
+    { 0x9F, 0x00 },  /* 'E' */
+    { 0xB7, 0x00 },  /* 'S' */
+    { 0xB7, 0x00 },  /* 'S' */
+    { 0x90, 0x50 },  /* 'I' */
+    { 0x6C, 0x82 },  /* 'N' */
+    { 0xBD, 0x00 },  /* 'G' */
+    { 0x00, 0x00 },  /* ' ' */
+    { 0xB7, 0x00 },  /* 'S' */
+    { 0x60, 0x20 },  /* '1' */
+    { 0x00, 0x00 },  /* ' ' */
+    { 0x00, 0x00 },  /* ' ' */
+    { 0x00, 0x00 },  /* ' ' */
+    { 0x00, 0x00 },  /* ' ' */
+    { 0x00, 0x00 },  /* ' ' */
+    { 0x00, 0x00 }   /* ' ' */
+};
+
+// "LEVEL"
+static const char cellsLevel[17][2] =
+{
+    { 0x00, 0x00 },  /* ' ' */
+    { 0x00, 0x00 },  /* ' ' */
+    { 0x00, 0x00 },  /* ' ' */
+    { 0x00, 0x00 },  /* ' ' */
+    { 0x00, 0x00 },  /* ' ' */
+    { 0x00, 0x00 },  /* ' ' */
+    { 0x1C, 0x00 },  /* 'L' */
+    { 0x9F, 0x00 },  /* 'E' */
+    { 0x0C, 0x28 },  /* 'V' */
+    { 0x9F, 0x00 },  /* 'E' */
+    { 0x1C, 0x00 },  /* 'L' */
+    { 0x00, 0x00 },  /* ' ' */
+    { 0x00, 0x00 },  /* ' ' */
+    { 0x00, 0x00 },  /* ' ' */
+    { 0x00, 0x00 },  /* ' ' */
+    { 0x00, 0x00 },  /* ' ' */
+    { 0x00, 0x00 }   /* ' ' */
+};
+
+// "WATCH"
+static const char cellsWatch[17][2] =
+{
+    { 0x00, 0x00 },  /* ' ' */
+    { 0x00, 0x00 },  /* ' ' */
+    { 0x00, 0x00 },  /* ' ' */
+    { 0x00, 0x00 },  /* ' ' */
+    { 0x00, 0x00 },  /* ' ' */
+    { 0x00, 0x00 },  /* ' ' */
+    { 0x6C, 0x0A },  /* 'W' */
+    { 0xEF, 0x00 },  /* 'A' */
+    { 0x80, 0x50 },  /* 'T' */
+    { 0x9C, 0x00 },  /* 'C' */
+    { 0x6F, 0x00 },  /* 'H' */
+    { 0x00, 0x00 },  /* ' ' */
+    { 0x00, 0x00 },  /* ' ' */
+    { 0x00, 0x00 },  /* ' ' */
+    { 0x00, 0x00 },  /* ' ' */
+    { 0x00, 0x00 },  /* ' ' */
+    { 0x00, 0x00 }   /* ' ' */
+};
+
+// "GO"
+static const char cellsGo[14][2] =
+{
+    { 0x00, 0x00 },  /* ' ' */
+    { 0x00, 0x00 },  /* ' ' */
+    { 0x00, 0x00 },  /* ' ' */
+    { 0x00, 0x00 },  /* ' ' */
+    { 0x00, 0x00 },  /* ' ' */
+    { 0x00, 0x00 },  /* ' ' */
+    { 0xBD, 0x00 },  /* 'G' */
+    { 0xFC, 0x00 },  /* 'O' */
+    { 0x00, 0x00 },  /* ' ' */
+    { 0x00, 0x00 },  /* ' ' */
+    { 0x00, 0x00 },  /* ' ' */
+    { 0x00, 0x00 },  /* ' ' */
+    { 0x00, 0x00 },  /* ' ' */
+    { 0x00, 0x00 }   /* ' ' */
+};
+
+// "YOU WIN"
+static const char cellsYouWin[19][2] =
+{
+    { 0x00, 0x00 },  /* ' ' */
+    { 0x00, 0x00 },  /* ' ' */
+    { 0x00, 0x00 },  /* ' ' */
+    { 0x00, 0x00 },  /* ' ' */
+    { 0x00, 0x00 },  /* ' ' */
+    { 0x00, 0x00 },  /* ' ' */
+    { 0x00, 0xB0 },  /* 'Y' */
+    { 0xFC, 0x00 },  /* 'O' */
+    { 0x7C, 0x00 },  /* 'U' */
+    { 0x00, 0x00 },  /* ' ' */
+    { 0x6C, 0x0A },  /* 'W' */
+    { 0x90, 0x50 },  /* 'I' */
+    { 0x6C, 0x82 },  /* 'N' */
+    { 0x00, 0x00 },  /* ' ' */
+    { 0x00, 0x00 },  /* ' ' */
+    { 0x00, 0x00 },  /* ' ' */
+    { 0x00, 0x00 },  /* ' ' */
+    { 0x00, 0x00 },  /* ' ' */
+    { 0x00, 0x00 }   /* ' ' */
+};
+
+// "GAME OVER FINAL SCORE"
+static const char cellsGameOver[33][2] =
+{
+    { 0x00, 0x00 },  /* ' ' */
+    { 0x00, 0x00 },  /* ' ' */
+    { 0x00, 0x00 },  /* ' ' */
+    { 0x00, 0x00 },  /* ' ' */
+    { 0x00, 0x00 },  /* ' ' */
+    { 0x00, 0x00 },  /* ' ' */
+    { 0xBD, 0x00 },  /* 'G' */
+    { 0xEF, 0x00 },  /* 'A' */
+    { 0x6C, 0xA0 },  /* 'M' */
+    { 0x9F, 0x00 },  /* 'E' */
+    { 0x00, 0x00 },  /* ' ' */
+    { 0xFC, 0x00 },  /* 'O' */
+    { 0x0C, 0x28 },  /* 'V' */
+    { 0x9F, 0x00 },  /* 'E' */
+    { 0xCF, 0x02 },  /* 'R' */
+    { 0x00, 0x00 },  /* ' ' */
+    { 0x8F, 0x00 },  /* 'F' */
+    { 0x90, 0x50 },  /* 'I' */
+    { 0x6C, 0x82 },  /* 'N' */
+    { 0xEF, 0x00 },  /* 'A' */
+    { 0x1C, 0x00 },  /* 'L' */
+    { 0x00, 0x00 },  /* ' ' */
+    { 0xB7, 0x00 },  /* 'S' */
+    { 0x9C, 0x00 },  /* 'C' */
+    { 0xFC, 0x00 },  /* 'O' */
+    { 0xCF, 0x02 },  /* 'R' */
+    { 0x9F, 0x00 },  /* 'E' */
+    { 0x00, 0x00 },  /* ' ' */
+    { 0x00, 0x00 },  /* ' ' */
+    { 0x00, 0x00 },  /* ' ' */
+    { 0x00, 0x00 },  /* ' ' */
+    { 0x00, 0x00 },  /* ' ' */
+    { 0x00, 0x00 }   /* ' ' */
+};
+
+const Message messages[MSG_COUNT] =
+{
+    { cellsBegin, 20 },
+    { cellsLevel, 5 },
+    { cellsWatch, 5 },
+    { cellsGo, 2 },
+    { cellsYouWin, 7 },
+    { cellsGameOver, 21 }
+};
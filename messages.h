@@ -0,0 +1,57 @@
+/******************************************************************************
+ *
+ * FILE: messages.h
+ *
+ * PURPOSE:
+ *   The fixed texts of the game, kept as LCD segment bytes in FRAM so
+ *   showing one is a copy and never a glyph lookup.
+ *
+ *   LCD_MESSAGES below is the list of texts. host/messageGen.c encodes
+ *   each one with the glyphs of lcdGlyphs.h and writes messages.c, which
+ *   is checked in like any other source. After changing a text or a
+ *   glyph, regenerate it from the repository root:
+ *
+ *     gcc -O2 -DHAL_HOST -Ihost -I. host/messageGen.c -o messageGen
+ *     ./messageGen > messages.c
+ *
+ *   Every text is stored with LCD_NUM_CHAR blank cells on both sides.
+ *   Scroll frame n is then the LCD_NUM_CHAR cells from cell n: the first
+ *   frame is blank, the text comes in from the right and the last frame
+ *   holds its last character on the far left. The text itself starts at
+ *   cell LCD_NUM_CHAR, which is the frame that shows a short word.
+ *
+ * CREATED BY:
+ *   Hanna Szalai & Haroun Riahi
+ *
+ ******************************************************************************/
+
+#ifndef LCD_MESSAGES_H_
+#define LCD_MESSAGES_H_
+
+#include "stdint.h"
+
+#define LCD_MESSAGES( X )                                   \
+    X( MSG_BEGIN,       "BEGIN BY PRESSING S1" )            \
+    X( MSG_LEVEL,       "LEVEL" )                           \
+    X( MSG_WATCH,       "WATCH" )                           \
+    X( MSG_GO,          "GO" )                              \
+    X( MSG_YOU_WIN,     "YOU WIN" )                         \
+    X( MSG_GAME_OVER,   "GAME OVER FINAL SCORE" )
+
+#define MESSAGE_ID( id, text )  id,
+
+enum
+{
+    LCD_MESSAGES( MESSAGE_ID )
+    MSG_COUNT
+};
+
+typedef struct
+{
+    const char (*cells)[2];     // Segment bytes, blanks on both sides included
+    uint16_t length;            // Characters of the text
+} Message;
+
+extern const Message messages[MSG_COUNT];
+
+#endif
@@ -0,0 +1,157 @@
+/******************************************************************************
+ *
+ * FILE: playback.c
+ *
+ * DESCRIPTION:
+ *   LED playback run by the scheduler tick (see playback.h).
+ *   - The events sit in a ring buffer. Each one counts its own ticks
+ *     down in place while it is at the tail; when it reaches zero the
+ *     tick sets the LEDs and moves on to the next one.
+ *   - The game loop adds events at the head and only sleeps while the
+ *     ring is full. The tick wakes it once the ring is down to half, so
+ *     a long round costs one wake-up per half ring, not one per event.
+ *   - Running out of events before playbackFinish only pauses the
+ *     playback; with the ring refilled at half, that does not happen.
+ *
+ * CREATED BY:
+ *   Hanna Szalai & Haroun Riahi
+ *
+ ******************************************************************************/
+
+#include <driverlib.h>
+#include "playback.h"
+#include "scheduler.h"
+#include "gpioSetup.h"
+
+// Must be a power of two
+#define PLAYBACK_QUEUE_SIZE     16
+
+typedef struct
+{
+    uint16_t ticks;         // Ticks left before the event runs
+    uint8_t  leds;          // PLAYBACK_LED_ bits to light, the rest go off
+} PlaybackEvent;
+
+static volatile PlaybackEvent queue[PLAYBACK_QUEUE_SIZE];
+static volatile uint8_t queueHead = 0;
+static volatile uint8_t queueTail = 0;
+
+static volatile uint8_t playing = 0;        // From playbackStart until done
+static volatile uint8_t finished = 0;       // No more events will be added
+static uint32_t lastEventTick = 0;          // Tick the newest event runs at
+
+static void setLeds(uint8_t leds)
+{
+    if (leds & PLAYBACK_LED_RED)
+    {
+        P1OUT |= RED_ON;
+    }
+    else
+    {
+        P1OUT &= RED_OFF;
+    }
+
+    if (leds & PLAYBACK_LED_GREEN)
+    {
+        P9OUT |= GREEN_ON;
+    }
+    else
+    {
+        P9OUT &= GREEN_OFF;
+    }
+}
+
+void playbackStart(void)
+{
+    __disable_interrupt();
+    queueHead = 0;
+    queueTail = 0;
+    finished = 0;
+    playing = 1;
+    lastEventTick = tickCount;
+    __enable_interrupt();
+}
+
+uint32_t playbackQueue(uint16_t ticks, uint8_t leds)
+{
+    uint8_t next = (queueHead + 1) & (PLAYBACK_QUEUE_SIZE - 1);
+
+    if (ticks == 0)
+    {
+        ticks = 1;
+    }
+
+    __disable_interrupt();
+    while (next == queueTail)
+    {
+        enterSleep();
+    }
+    __enable_interrupt();
+
+    // The tick does not look at the head until it has moved past it
+    queue[queueHead].ticks = ticks;
+    queue[queueHead].leds = leds;
+    queueHead = next;
+
+    lastEventTick += ticks;
+    return lastEventTick;
+}
+
+void playbackFinish(void)
+{
+    finished = 1;
+}
+
+uint8_t playbackDone(void)
+{
+    return !playing;
+}
+
+void waitPlayback(void)
+{
+    __disable_interrupt();
+    while (playing)
+    {
+        enterSleep();
+    }
+    __enable_interrupt();
+}
+
+uint8_t playbackTick(void)
+{
+    uint8_t tail = queueTail;
+
+    if (!playing)
+    {
+        return 0;
+    }
+
+    if (tail == queueHead)
+    {
+        // Done, or waiting for the game loop to add more
+        if (finished)
+        {
+            playing = 0;
+            return 1;
+        }
+        return 0;
+    }
+
+    if (--queue[tail].ticks)
+    {
+        return 0;
+    }
+
+    setLeds(queue[tail].leds);
+    tail = (tail + 1) & (PLAYBACK_QUEUE_SIZE - 1);
+    queueTail = tail;
+
+    if (tail == queueHead && finished)
+    {
+        playing = 0;
+        return 1;
+    }
+
+    // Half the ring is free again: let the game loop top it up
+    return ((queueHead - tail) & (PLAYBACK_QUEUE_SIZE - 1)) == PLAYBACK_QUEUE_SIZE / 2;
+}
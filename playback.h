@@ -0,0 +1,51 @@
+/******************************************************************************
+ *
+ * FILE: playback.h
+ *
+ * PURPOSE:
+ *   Declares the LED playback queue. The game loop turns a round into a
+ *   list of events, each an LED state and the ticks to wait before it,
+ *   and the 10 ms scheduler tick carries them out while the CPU sleeps.
+ *   The LEDs change on the tick itself, so the timing does not depend on
+ *   how long the game loop takes to build the list.
+ *
+ *   A round longer than the queue is built as it plays: playbackQueue
+ *   sleeps while the queue is full, and the tick wakes the game loop
+ *   again when half of it has been played.
+ *
+ * CREATED BY:
+ *   Hanna Szalai & Haroun Riahi
+ *
+ ******************************************************************************/
+
+#ifndef LCD_PLAYBACK_H_
+#define LCD_PLAYBACK_H_
+
+#include "stdint.h"
+
+// LED states of an event
+#define PLAYBACK_LEDS_OFF       0x00
+#define PLAYBACK_LED_RED        0x01
+#define PLAYBACK_LED_GREEN      0x02
+
+// Starts a new list; its first event counts from the next tick
+void playbackStart(void);
+
+// Adds an event that sets the LEDs the given number of ticks (at least 1)
+// after the event before it. Sleeps while the queue is full. Returns the
+// tickCount the event will run at.
+uint32_t playbackQueue(uint16_t ticks, uint8_t leds);
+
+// No more events: the playback is done once the queued ones have run
+void playbackFinish(void);
+
+// 1 once the list is finished and all its events have run
+uint8_t playbackDone(void);
+
+// Sleeps in LPM3 until playbackDone
+void waitPlayback(void);
+
+// Called from the scheduler tick; returns 1 to wake the game loop up
+uint8_t playbackTick(void);
+
+#endif
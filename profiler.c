@@ -0,0 +1,106 @@
+/******************************************************************************
+ *
+ * FILE: profiler.c
+ *
+ * DESCRIPTION:
+ *   Probe table of the profiling build (see profiler.h).
+ *   - Each probe keeps count, minimum, maximum and sum of its runs in
+ *     Timer_A0 counts, 12 bytes of RAM a probe.
+ *   - profileDump prints them scaled to MCLK cycles, one line a probe:
+ *     name, runs, minimum, maximum and average. It waits for each line to
+ *     go out, so the table never overflows the UART buffer.
+ *
+ *   Compiled only when PROFILING is defined.
+ *
+ * CREATED BY:
+ *   Hanna Szalai & Haroun Riahi
+ *
+ ******************************************************************************/
+
+#ifdef PROFILING
+
+#include <driverlib.h>
+#include "profiler.h"
+#include "uart.h"
+
+typedef struct
+{
+    uint32_t count;
+    uint32_t sum;
+    uint16_t min;
+    uint16_t max;
+} ProbeTimes;
+
+uint16_t profileStarts[PROBE_COUNT];
+
+static ProbeTimes probes[PROBE_COUNT];
+
+static const char * const probeNames[PROBE_COUNT] =
+{
+    "LCD_SHOWCHAR", "LCD_COMMIT", "CLEARDISPLAY", "SCROLL_FRAME",
+    "PLAYBACK_STEP", "INPUT_EVENT", "TICK_ISR", "PORT1_ISR",
+    "UART_ISR", "DMA_ISR", "TIMERB_ISR"
+};
+
+void profileRecord(uint8_t probe, uint16_t counts)
+{
+    ProbeTimes *times = &probes[probe];
+
+    if (!times->count || counts < times->min)
+    {
+        times->min = counts;
+    }
+    if (counts > times->max)
+    {
+        times->max = counts;
+    }
+    times->sum += counts;
+    times->count++;
+}
+
+void profileReset(void)
+{
+    uint8_t probe;
+
+    for (probe = 0; probe < PROBE_COUNT; probe++)
+    {
+        probes[probe].count = 0;
+        probes[probe].sum = 0;
+        probes[probe].min = 0;
+        probes[probe].max = 0;
+    }
+}
+
+void profileDump(void)
+{
+    uint32_t smclk = CS_getSMCLK();
+    uint32_t scale = smclk ? CS_getMCLK() / smclk : 1;
+    const ProbeTimes *times;
+    uint8_t probe;
+
+    uartPrint("PROFILE IN MCLK CYCLES\r\nPROBE RUNS MIN MAX AVG\r\n");
+    uartFlush();
+
+    for (probe = 0; probe < PROBE_COUNT; probe++)
+    {
+        times = &probes[probe];
+        if (!times->count)
+        {
+            continue;
+        }
+
+        uartPrint(probeNames[probe]);
+        uartPrint(" ");
+        uartPrintNumber(times->count);
+        uartPrint(" ");
+        uartPrintNumber((uint32_t)times->min * scale);
+        uartPrint(" ");
+        uartPrintNumber((uint32_t)times->max * scale);
+        uartPrint(" ");
+        uartPrintNumber(times->sum / times->count * scale);
+        uartPrint("\r\n");
+        uartFlush();
+    }
+}
+
+#endif
@@ -0,0 +1,80 @@
+/******************************************************************************
+ *
+ * FILE: profiler.h
+ *
+ * PURPOSE:
+ *   Probe macros for timing the hot paths of the game on the board.
+ *   PROFILE_START/PROFILE_STOP around a piece of code add its length to
+ *   the probe's count, minimum, maximum and sum, and PROFILE_DUMP prints
+ *   the table over the UART in MCLK cycles.
+ *
+ *   The probes only exist in builds with PROFILING defined (add it to the
+ *   predefined symbols of the CCS build configuration). Without it every
+ *   macro is empty and profiler.c compiles to nothing, so normal builds
+ *   carry no code, RAM or time for them.
+ *
+ *   The time base is the scheduler's activeTimeCounter: Timer_A0, which
+ *   main() runs from SMCLK in continuous mode, with the counts of every
+ *   sleep left out, even those the UART keeps SMCLK running through. A
+ *   probe around a wait only counts the time the CPU was awake, ISRs
+ *   included. A probe must not be longer than 65536 SMCLK counts (32 ms
+ *   at 2 MHz).
+ *
+ * CREATED BY:
+ *   Hanna Szalai & Haroun Riahi
+ *
+ ******************************************************************************/
+
+#ifndef LCD_PROFILER_H_
+#define LCD_PROFILER_H_
+
+#include "stdint.h"
+
+// Probes
+#define PROBE_LCD_SHOW_CHAR     0
+#define PROBE_LCD_COMMIT        1
+#define PROBE_CLEAR_DISPLAY     2
+#define PROBE_SCROLL_FRAME      3
+#define PROBE_PLAYBACK_STEP     4
+#define PROBE_INPUT_EVENT       5
+#define PROBE_TICK_ISR          6
+#define PROBE_PORT1_ISR         7
+#define PROBE_UART_ISR          8
+#define PROBE_DMA_ISR           9
+#define PROBE_TIMER_B_ISR       10
+#define PROBE_COUNT             11
+
+#ifdef PROFILING
+
+#include "scheduler.h"
+
+// Counter the probes read
+#define PROFILE_COUNTER         activeTimeCounter()
+
+extern uint16_t profileStarts[PROBE_COUNT];
+
+#define PROFILE_START(probe)    (profileStarts[(probe)] = PROFILE_COUNTER)
+#define PROFILE_STOP(probe)     profileRecord((probe), \
+                                    (uint16_t)(PROFILE_COUNTER - profileStarts[(probe)]))
+#define PROFILE_RESET()         profileReset()
+#define PROFILE_DUMP()          profileDump()
+
+// Adds one run of a probe, in counts of PROFILE_COUNTER
+void profileRecord(uint8_t probe, uint16_t counts);
+
+// Clears every probe
+void profileReset(void);
+
+// Prints every probe that ran over the UART and waits until it is sent
+void profileDump(void);
+
+#else
+
+#define PROFILE_START(probe)    ((void)0)
+#define PROFILE_STOP(probe)     ((void)0)
+#define PROFILE_RESET()         ((void)0)
+#define PROFILE_DUMP()          ((void)0)
+
+#endif
+
+#endif
@@ -0,0 +1,232 @@
+/******************************************************************************
+ *
+ * FILE: reactionTimer.c
+ *
+ * DESCRIPTION:
+ *   Button timing with Timer_B0 in capture mode.
+ *   - Timer_B0 counts ACLK in continuous mode, so it keeps running in
+ *     LPM3. Its overflow interrupt counts the upper 16 bits.
+ *   - Capture registers 1 and 2 (one per button) use the software
+ *     capture of the user's guide: the input is switched between GND
+ *     and VCC, and every switch latches TB0R. The port 1 interrupt does
+ *     this on the first edge of a press or release, so the time is taken
+ *     within microseconds of the edge, not at the debounce tick 20 ms later.
+ *   - A captured value is put back into 32 bits from the time it is read:
+ *     the counts since the capture fit in 16 bits, so they are simply
+ *     taken off the current 32-bit count.
+ *   - Counts are turned into microseconds only when a time is asked for,
+ *     with a fixed-point multiplier worked out when ACLK changes: a
+ *     multiply and a shift instead of a divide per time.
+ *
+ * CREATED BY:
+ *   Hanna Szalai & Haroun Riahi
+ *
+ ******************************************************************************/
+
+#include <driverlib.h>
+#include "reactionTimer.h"
+#include "clockConfig.h"
+#include "scheduler.h"
+#include "profiler.h"
+
+// Capture on both edges of the GND/VCC input, in sync with the timer clock
+#define SOFTWARE_CAPTURE    (CM_3 | CCIS_2 | SCS | CAP)
+
+typedef struct
+{
+    uint32_t press;         // Counts from the end of the playback
+    uint32_t release;       // Same, or 0 while the button is still down
+} PressTimes;
+
+// Fixed-point microseconds and milliseconds per count. Microseconds keep
+// 16 fraction bits; milliseconds, about a thousand times smaller, keep 26.
+#define US_SHIFT            16
+#define MS_SHIFT            26
+
+static volatile uint16_t overflowCount = 0;
+static uint32_t usPerCount = 0;
+static uint32_t msPerCount = 0;
+
+static uint32_t roundStart = 0;
+static PressTimes presses[REACTION_MAX_PRESSES];
+static uint16_t pressCount = 0;
+static uint8_t  pressHeld = 0;
+
+// ACLK changed. Counts taken before the change are converted at the new
+// rate too; this only happens once, within seconds of the boot.
+static void reactionClockChanged(uint32_t aclk)
+{
+    usPerCount = (uint32_t)(((1000000ULL << US_SHIFT) + aclk / 2) / aclk);
+    msPerCount = (uint32_t)(((1000ULL << MS_SHIFT) + aclk / 2) / aclk);
+}
+
+void initializeReactionTimer(void)
+{
+    uint8_t channel;
+
+    reactionClockChanged(clockRequest(CLOCK_ACLK, REACTION_CLOCK_MIN_HZ));
+    clockWatch(CLOCK_ACLK, reactionClockChanged);
+
+    TB0CTL = TBSSEL__ACLK | MC__STOP | TBCLR;
+    for (channel = 0; channel < REACTION_CHANNEL_COUNT; channel++)
+    {
+        (&TB0CCTL1)[channel] = SOFTWARE_CAPTURE;
+    }
+    overflowCount = 0;
+    TB0CTL = TBSSEL__ACLK | MC__CONTINUOUS | TBCLR | TBIE;
+}
+
+uint32_t reactionNow(void)
+{
+    uint16_t high;
+    uint16_t low;
+    uint8_t pending;
+
+    do
+    {
+        high = overflowCount;
+
+        // TB0R runs from ACLK, not MCLK, so a read can catch it changing
+        do
+        {
+            low = TB0R;
+        } while (low != TB0R);
+
+        // An overflow the interrupt has not counted yet (we may be in
+        // another ISR). A small count means it happened before the read.
+        pending = (TB0CTL & TBIFG) && low < 0x8000;
+    } while (high != overflowCount);
+
+    return ((uint32_t)(uint16_t)(high + pending) << 16) | low;
+}
+
+void reactionCaptureEdge(uint8_t channel)
+{
+    (&TB0CCTL1)[channel] ^= CCIS0;
+}
+
+uint32_t reactionCapturedTime(uint8_t channel)
+{
+    uint32_t now = reactionNow();
+    uint16_t captured = (&TB0CCR1)[channel];
+
+    return now - (uint16_t)((uint16_t)now - captured);
+}
+
+// Counts from the end of the playback; edges from before it count as 0
+static uint32_t sinceRoundStart(uint32_t time)
+{
+    return (int32_t)(time - roundStart) > 0 ? time - roundStart : 0;
+}
+
+// Counts to microseconds, rounded
+static uint32_t toMicroseconds(uint32_t counts)
+{
+    return (uint32_t)(((uint64_t)counts * usPerCount + (1UL << (US_SHIFT - 1))) >> US_SHIFT);
+}
+
+// Counts to milliseconds, rounded
+static uint32_t toMilliseconds(uint32_t counts)
+{
+    return (uint32_t)(((uint64_t)counts * msPerCount + (1UL << (MS_SHIFT - 1))) >> MS_SHIFT);
+}
+
+uint32_t reactionAgeMs(uint32_t time)
+{
+    return toMilliseconds(reactionNow() - time);
+}
+
+void reactionStartRound(void)
+{
+    roundStart = reactionNow();
+    pressCount = 0;
+    pressHeld = 0;
+}
+
+void reactionRecordPress(uint32_t time)
+{
+    if (pressCount < REACTION_MAX_PRESSES)
+    {
+        presses[pressCount].press = sinceRoundStart(time);
+        presses[pressCount].release = 0;
+    }
+    pressCount++;
+    pressHeld = 1;
+}
+
+void reactionRecordRelease(uint32_t time)
+{
+    // A button already down when the round started has no press
+    if (!pressHeld)
+    {
+        return;
+    }
+    pressHeld = 0;
+
+    if (pressCount <= REACTION_MAX_PRESSES)
+    {
+        presses[pressCount - 1].release = sinceRoundStart(time);
+    }
+}
+
+uint16_t reactionPressCount(void)
+{
+    return pressCount;
+}
+
+uint32_t reactionPressUs(uint16_t press)
+{
+    if (press >= pressCount || press >= REACTION_MAX_PRESSES)
+    {
+        return 0;
+    }
+    return toMicroseconds(presses[press].press);
+}
+
+// Reaction time of a press in counts (0 if it was not kept)
+static uint32_t reactionCounts(uint16_t press)
+{
+    uint32_t from = 0;
+
+    if (press >= pressCount || press >= REACTION_MAX_PRESSES)
+    {
+        return 0;
+    }
+    if (press > 0 && presses[press - 1].release <= presses[press].press)
+    {
+        from = presses[press - 1].release;
+    }
+    return presses[press].press - from;
+}
+
+uint32_t reactionTimeUs(uint16_t press)
+{
+    return toMicroseconds(reactionCounts(press));
+}
+
+uint32_t reactionTimeMs(uint16_t press)
+{
+    return toMilliseconds(reactionCounts(press));
+}
+
+uint32_t reactionHoldUs(uint16_t press)
+{
+    if (press >= pressCount || press >= REACTION_MAX_PRESSES
+        || presses[press].release < presses[press].press)
+    {
+        return 0;
+    }
+    return toMicroseconds(presses[press].release - presses[press].press);
+}
+
+// Timer_B0 overflow Interrupt Service Routine (upper 16 bits of the count)
+#pragma vector=TIMER0_B1_VECTOR
+__interrupt void Timer0_B1 (void)
+{
+    activeTimeIsrStart();
+    PROFILE_START(PROBE_TIMER_B_ISR);
+    TB0CTL &= ~TBIFG;
+    overflowCount++;
+    PROFILE_STOP(PROBE_TIMER_B_ISR);
+    activeTimeIsrEnd();
+}
@@ -0,0 +1,71 @@
+/******************************************************************************
+ *
+ * FILE: reactionTimer.h
+ *
+ * PURPOSE:
+ *   Declares the reaction timer: Timer_B0 counting ACLK in continuous
+ *   mode, extended to 32 bits by counting its overflows. The button
+ *   interrupt latches the count of each edge in a capture register, so
+ *   press and release times are exact to one ACLK period (about 31 us)
+ *   instead of to the 10 ms debounce tick.
+ *
+ *   Each round, the presses are timed from the end of the last LED of
+ *   the playback:
+ *   - reaction time: from the end of the playback (first press) or from
+ *     the release of the previous press, to this press
+ *   - hold time: from the press to its release
+ *
+ * CREATED BY:
+ *   Hanna Szalai & Haroun Riahi
+ *
+ ******************************************************************************/
+
+#ifndef LCD_REACTIONTIMER_H_
+#define LCD_REACTIONTIMER_H_
+
+#include "stdint.h"
+
+// Slowest ACLK that still times a press to 125 us
+#define REACTION_CLOCK_MIN_HZ   8000UL
+
+// Presses of a round whose times are kept; later ones are only counted
+#define REACTION_MAX_PRESSES    32
+
+// Capture registers of Timer_B0 used for the two buttons
+#define REACTION_CHANNEL_COUNT  2
+
+// Starts Timer_B0 from the ACLK set up by initializeClocks
+void initializeReactionTimer(void);
+
+// Timer counts since initializeReactionTimer (32 bits)
+uint32_t reactionNow(void);
+
+// Latches the count in the capture register of a button (0 or 1). Called
+// from the port interrupt on the first edge of a press or release.
+void reactionCaptureEdge(uint8_t channel);
+
+// The last count latched for a button, extended to 32 bits. Must be read
+// within one timer period (2 s at 32768 Hz) of the capture.
+uint32_t reactionCapturedTime(uint8_t channel);
+
+// Marks the end of the playback and clears the presses of the last round
+void reactionStartRound(void);
+
+// Records a press or the release of the last press, by their edge times
+void reactionRecordPress(uint32_t time);
+void reactionRecordRelease(uint32_t time);
+
+// Presses recorded in this round
+uint16_t reactionPressCount(void);
+
+// Milliseconds from a count of reactionNow or reactionCapturedTime to now,
+// rounded
+uint32_t reactionAgeMs(uint32_t time);
+
+// Times of a press of this round in microseconds (0 if it was not kept)
+uint32_t reactionPressUs(uint16_t press);      // From the end of the playback
+uint32_t reactionTimeUs(uint16_t press);
+uint32_t reactionTimeMs(uint16_t press);       // Same, in milliseconds
+uint32_t reactionHoldUs(uint16_t press);
+
+#endif
@@ -0,0 +1,192 @@
+/******************************************************************************
+ *
+ * FILE: scheduler.c
+ *
+ * DESCRIPTION:
+ *   Tick-driven low-power scheduler for the memory game.
+ *   - Timer_A1 runs in up mode from ACLK and interrupts every 10 ms.
+ *   - The ISR counts down the current deadline and wakes the CPU when
+ *     it reaches zero, so waiting costs no CPU time at all.
+ *   - Between ticks the core sleeps in LPM3 (only ACLK keeps running).
+ *   - The tick also lets clockConfig watch the crystal start, and the
+ *     period is worked out again when ACLK moves to or from the crystal.
+ *
+ *   CPU-active time is measured with Timer_A0, which runs from SMCLK.
+ *   LPM3 switches SMCLK off, but the eUSCI asks for it to run on while
+ *   it has bytes to send, and Timer_A0 then counts through the sleep.
+ *   So the counts of a sleep are thrown away: enterSleep charges the
+ *   time up to the sleep and starts again from TA0R when it wakes up,
+ *   and an ISR that runs while the CPU sleeps charges its own counts
+ *   (activeTimeIsrStart/activeTimeIsrEnd). The counts are charged to the
+ *   current game phase and to activeTimeCounter, the profiler's clock.
+ *
+ * CREATED BY:
+ *   Hanna Szalai & Haroun Riahi
+ *
+ ******************************************************************************/
+
+#include <driverlib.h>
+#include "scheduler.h"
+#include "buttons.h"
+#include "playback.h"
+#include "clockConfig.h"
+#include "profiler.h"
+
+volatile uint32_t tickCount = 0;
+uint32_t phaseActiveTicks[PHASE_COUNT];
+
+// Ticks left before the current wait is over
+static volatile uint16_t ticksRemaining = 0;
+
+// Phase that active time is charged to, the last Timer_A0 sample and
+// the Timer_A0 counts charged so far
+static uint8_t  currentPhase = PHASE_INTRO;
+static uint16_t lastSample = 0;
+static uint16_t activeCount = 0;
+
+// Set by enterSleep while the CPU is in LPM3
+static volatile uint8_t asleep = 0;
+
+// Adds the Timer_A0 counts since the last sample to the current phase.
+// Must be called at least once per Timer_A0 period (~32 ms awake).
+static void sampleActiveTime(void)
+{
+    uint16_t now = TA0R;
+    uint16_t counts = now - lastSample;
+
+    lastSample = now;
+    activeCount += counts;
+    phaseActiveTicks[currentPhase] += counts;
+}
+
+// Timer_A1 period for a tick at this ACLK (up mode counts CCR0 + 1)
+static uint16_t tickPeriod(uint32_t aclk)
+{
+    return (uint16_t)((aclk + TICK_HZ / 2) / TICK_HZ - 1);
+}
+
+// ACLK changed: restart the current tick with the new period, so a count
+// already past a shorter period cannot run on to 0xFFFF
+static void tickClockChanged(uint32_t aclk)
+{
+    TA1CCR0 = tickPeriod(aclk);
+    TA1CTL |= TACLR;
+}
+
+// Sets up Timer_A1 to interrupt every 10 ms using ACLK. The period comes
+// from what ACLK really runs at.
+void initializeScheduler(void)
+{
+    uint32_t aclk = clockRequest(CLOCK_ACLK, TICK_CLOCK_MIN_HZ);
+
+    TA1CTL   = TASSEL__ACLK | MC__STOP | TACLR;
+    TA1CCR0  = tickPeriod(aclk);
+    TA1CCTL0 = CCIE;
+    TA1CTL   = TASSEL__ACLK | MC__UP | TACLR;
+    clockWatch(CLOCK_ACLK, tickClockChanged);
+
+    lastSample = TA0R;
+}
+
+// Sleeps in LPM3 until an interrupt wakes the CPU up.
+// Interrupts must be disabled by the caller between checking its wake-up
+// condition and calling this, otherwise the wake-up could be missed and we
+// would never return. Interrupts are disabled again on return.
+void enterSleep(void)
+{
+    sampleActiveTime();
+    asleep = 1;
+    __bis_SR_register(LPM3_bits | GIE);
+    __disable_interrupt();
+    asleep = 0;
+
+    // Whatever Timer_A0 counted while asleep was not the CPU's
+    lastSample = TA0R;
+}
+
+// While the CPU is awake its ISRs are counted with the rest of its time
+void activeTimeIsrStart(void)
+{
+    if (asleep)
+    {
+        lastSample = TA0R;
+    }
+}
+
+void activeTimeIsrEnd(void)
+{
+    if (asleep)
+    {
+        sampleActiveTime();
+    }
+}
+
+uint16_t activeTimeCounter(void)
+{
+    return activeCount + (uint16_t)(TA0R - lastSample);
+}
+
+// Sleeps until the requested number of ticks have passed
+void waitTicks(uint16_t ticks)
+{
+    __disable_interrupt();
+    ticksRemaining = ticks;
+
+    while (ticksRemaining)
+    {
+        enterSleep();
+    }
+
+    __enable_interrupt();
+}
+
+void setGamePhase(uint8_t phase)
+{
+    sampleActiveTime();
+    currentPhase = phase;
+}
+
+void resetPhaseTimes(void)
+{
+    uint8_t i;
+
+    for (i = 0; i < PHASE_COUNT; i++)
+    {
+        phaseActiveTicks[i] = 0;
+    }
+    lastSample = TA0R;
+}
+
+// Timer_A1 CCR0 Interrupt Service Routine (10 ms system tick)
+#pragma vector=TIMER1_A0_VECTOR
+__interrupt void Timer_A1 (void)
+{
+    activeTimeIsrStart();
+    PROFILE_START(PROBE_TICK_ISR);
+    tickCount++;
+    clockTick();
+
+    // Sample the buttons being debounced, wake up if a new event is ready
+    if (debounceButtons())
+    {
+        __bic_SR_register_on_exit(LPM3_bits);
+    }
+
+    // Run the LED playback, wake up when it needs more events or is done
+    if (playbackTick())
+    {
+        __bic_SR_register_on_exit(LPM3_bits);
+    }
+
+    if (ticksRemaining)
+    {
+        ticksRemaining--;
+        if (ticksRemaining == 0)
+        {
+            // Deadline reached, return to the code that went to sleep
+            __bic_SR_register_on_exit(LPM3_bits);
+        }
+    }
+    PROFILE_STOP(PROBE_TICK_ISR);
+    activeTimeIsrEnd();
+}
@@ -0,0 +1,65 @@
+/******************************************************************************
+ *
+ * FILE: scheduler.h
+ *
+ * PURPOSE:
+ *   Declares the tick-driven scheduler that replaces the old busy-wait
+ *   delay() loops. Timer_A1 generates one tick every 10 ms and the CPU
+ *   sleeps in LPM3 between ticks until the requested wait has elapsed.
+ *
+ *   Also declares the per-phase CPU-active time counters, which can be
+ *   printed over UART and read on the host to see where active time goes.
+ *
+ * CREATED BY:
+ *   Hanna Szalai & Haroun Riahi
+ *
+ ******************************************************************************/
+
+#ifndef LCD_SCHEDULER_H_
+#define LCD_SCHEDULER_H_
+
+#include "stdint.h"
+
+// Ticks per second, and the slowest ACLK that still puts 50 counts in a
+// tick (the rounded period is then within 1 %)
+#define TICK_HZ             100
+#define TICK_CLOCK_MIN_HZ   (50UL * TICK_HZ)
+
+// Game phases that CPU-active time is measured for
+#define PHASE_INTRO     0
+#define PHASE_BANNER    1
+#define PHASE_PLAYBACK  2
+#define PHASE_INPUT     3
+#define PHASE_GAMEOVER  4
+#define PHASE_COUNT     5
+
+// Number of 10 ms ticks since the scheduler was started
+extern volatile uint32_t tickCount;
+
+// SMCLK cycles spent awake in each phase, ISRs included
+extern uint32_t phaseActiveTicks[PHASE_COUNT];
+
+// Starts Timer_A1 as the 10 ms system tick
+void initializeScheduler(void);
+
+// Sleeps in LPM3 until any interrupt wakes the CPU (call with interrupts off)
+void enterSleep(void);
+
+// Sleeps in LPM3 for the given number of 10 ms ticks
+void waitTicks(uint16_t ticks);
+
+// Switches the phase that CPU-active time is charged to
+void setGamePhase(uint8_t phase);
+
+// Clears all per-phase active time counters
+void resetPhaseTimes(void);
+
+// Called first and last in every ISR that can run while the CPU sleeps,
+// so its time is counted even when the UART keeps Timer_A0 running
+void activeTimeIsrStart(void);
+void activeTimeIsrEnd(void);
+
+// Free-running count of the SMCLK cycles the CPU has been awake
+uint16_t activeTimeCounter(void);
+
+#endif
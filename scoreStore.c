@@ -0,0 +1,190 @@
+/******************************************************************************
+ *
+ * FILE: scoreStore.c
+ *
+ * DESCRIPTION:
+ *   Score store in its own FRAM segment (see scoreStore.h).
+ *   - The store is placed in .scores, which the linker puts on a 1 KB
+ *     boundary between the persistent variables and the code. Those are
+ *     the three segments of the MPU: variables read/write, scores read
+ *     only, code read/execute.
+ *   - The section is not initialized by the loader or the C startup code.
+ *     A magic word marks a store that has been set up; without it the
+ *     store is cleared once and the magic written last.
+ *   - Writes only happen through FRAMCtl between openWriteWindow and
+ *     closeWriteWindow: interrupts off, segment 2 made writable, written,
+ *     made read-only again, interrupts back as the caller had them. No
+ *     ISR ever runs while the scores can be written.
+ *
+ * CREATED BY:
+ *   Hanna Szalai & Haroun Riahi
+ *
+ ******************************************************************************/
+
+#include <driverlib.h>
+#include "scoreStore.h"
+#include "telemetry.h"
+
+// Marks a set up store; change it when the layout changes
+#define SCORE_MAGIC     0x5C02
+
+typedef struct
+{
+    uint16_t magic;
+    uint16_t highScores[SCORE_TABLE_SIZE];      // In no particular order
+    uint32_t gamesPlayed;
+    uint32_t recordedGame;                      // Checkpoint number of the
+                                                // last game plus one, 0
+                                                // before the first
+    uint32_t gamesEndedAt[SCORE_LEVELS + 1];    // Games by points, last one
+                                                // for SCORE_LEVELS and over
+} ScoreStore;
+
+// Segment borders from the linker (lnk_msp430fr6989.cmd)
+extern uint8_t fram_scores_start;
+extern uint8_t fram_rx_start;
+
+#pragma DATA_SECTION(store, ".scores")
+static ScoreStore store;
+
+// Sets the three MPU segments, with the given access to the scores
+static void setScoreAccess(uint8_t access)
+{
+    MPU_initThreeSegmentsParam param;
+
+    param.seg1boundary = (uint16_t)((uintptr_t)&fram_scores_start >> 4);
+    param.seg2boundary = (uint16_t)((uintptr_t)&fram_rx_start >> 4);
+    param.seg1accmask  = MPU_READ | MPU_WRITE;
+    param.seg2accmask  = access;
+    param.seg3accmask  = MPU_READ | MPU_EXEC;
+    MPU_initThreeSegments(MPU_BASE, &param);
+}
+
+// Returns the interrupt state to give closeWriteWindow
+static uint16_t openWriteWindow(void)
+{
+    uint16_t interruptState = __get_interrupt_state();
+
+    __disable_interrupt();
+    setScoreAccess(MPU_READ | MPU_WRITE);
+    return interruptState;
+}
+
+static void closeWriteWindow(uint16_t interruptState)
+{
+    setScoreAccess(MPU_READ);
+    __set_interrupt_state(interruptState);
+}
+
+static void writeWord(uint16_t *word, uint16_t value)
+{
+    FRAMCtl_write16(&value, word, 1);
+}
+
+static void writeLong(uint32_t *word, uint32_t value)
+{
+    FRAMCtl_write32(&value, word, 1);
+}
+
+void initializeScoreStore(void)
+{
+    uint16_t interruptState;
+
+    setScoreAccess(MPU_READ);
+    MPU_start(MPU_BASE);
+
+    if (store.magic != SCORE_MAGIC)
+    {
+        interruptState = openWriteWindow();
+        FRAMCtl_fillMemory32(0, (uint32_t *)&store, sizeof(store) / 4);
+        writeWord(&store.magic, SCORE_MAGIC);
+        closeWriteWindow(interruptState);
+    }
+}
+
+void scoreRecordGame(uint16_t points, uint16_t game)
+{
+    uint32_t *ended = &store.gamesEndedAt[points < SCORE_LEVELS ? points : SCORE_LEVELS];
+    uint16_t *lowest = &store.highScores[0];
+    uint16_t interruptState;
+    uint8_t rank;
+
+    if (scoreGameRecorded(game))
+    {
+        return;
+    }
+
+    for (rank = 1; rank < SCORE_TABLE_SIZE; rank++)
+    {
+        if (store.highScores[rank] < *lowest)
+        {
+            lowest = &store.highScores[rank];
+        }
+    }
+
+    interruptState = openWriteWindow();
+    writeLong(ended, *ended + 1);
+    writeLong(&store.gamesPlayed, store.gamesPlayed + 1);
+    if (points > *lowest)
+    {
+        writeWord(lowest, points);
+    }
+    writeLong(&store.recordedGame, (uint32_t)game + 1);
+    closeWriteWindow(interruptState);
+}
+
+uint8_t scoreGameRecorded(uint16_t game)
+{
+    return store.recordedGame == (uint32_t)game + 1;
+}
+
+uint32_t scoreGamesPlayed(void)
+{
+    return store.gamesPlayed;
+}
+
+uint16_t scoreHighScore(uint8_t rank)
+{
+    uint8_t higher;
+    uint8_t i;
+    uint8_t j;
+
+    // The entry with exactly 'rank' entries above it (ties by position)
+    for (i = 0; i < SCORE_TABLE_SIZE; i++)
+    {
+        higher = 0;
+        for (j = 0; j < SCORE_TABLE_SIZE; j++)
+        {
+            if (store.highScores[j] > store.highScores[i]
+                || (store.highScores[j] == store.highScores[i] && j < i))
+            {
+                higher++;
+            }
+        }
+        if (higher == rank)
+        {
+            return store.highScores[i];
+        }
+    }
+    return 0;
+}
+
+uint32_t scoreLevelSuccesses(uint16_t level)
+{
+    uint32_t successes = 0;
+
+    if (level > SCORE_LEVELS)
+    {
+        return 0;
+    }
+    for (; level <= SCORE_LEVELS; level++)
+    {
+        successes += store.gamesEndedAt[level];
+    }
+    return successes;
+}
+
+uint8_t scoreSendStore(void)
+{
+    return telemetrySendBlock(TELEMETRY_SCORE_STORE, &store, sizeof(store));
+}
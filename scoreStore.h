@@ -0,0 +1,68 @@
+/******************************************************************************
+ *
+ * FILE: scoreStore.h
+ *
+ * PURPOSE:
+ *   Declares the score store: a high-score table, the number of games
+ *   played and how far each game got, kept in their own FRAM segment so
+ *   they survive resets and power cycles.
+ *
+ *   The segment (.scores in lnk_msp430fr6989.cmd) is segment 2 of the
+ *   MPU and read-only. Each update opens a short write window around its
+ *   FRAMCtl writes and closes it again, so a stray pointer anywhere else
+ *   in the program cannot change the scores.
+ *
+ *   Recording a game writes at most four words, whatever the size of
+ *   the tables:
+ *   - the games played counter
+ *   - the counter of games that ended with this score, from which the
+ *     successes of every level are worked out when asked for (a game with
+ *     N points passed levels 1 to N)
+ *   - the lowest entry of the high-score table, if the score beats it.
+ *     The table is not kept in order, so nothing has to be moved.
+ *   The checkpoint number of the game is written after them. A reset
+ *   before the checkpoint is cleared finds the game already recorded,
+ *   so it is neither resumed nor counted twice.
+ *
+ * CREATED BY:
+ *   Hanna Szalai & Haroun Riahi
+ *
+ ******************************************************************************/
+
+#ifndef LCD_SCORESTORE_H_
+#define LCD_SCORESTORE_H_
+
+#include "stdint.h"
+
+// Entries of the high-score table
+#define SCORE_TABLE_SIZE    5
+
+// Levels counted one by one; scores above this count as this many points
+#define SCORE_LEVELS        32
+
+// Checks the store and sets it up empty the first time, then leaves the
+// score segment write-protected
+void initializeScoreStore(void);
+
+// Adds a finished game with the points it scored. The game is named by
+// its checkpoint (checkpointSequence); a game already recorded under the
+// same name is not added again.
+void scoreRecordGame(uint16_t points, uint16_t game);
+
+// 1 if the game named by this checkpoint number is the last one recorded
+uint8_t scoreGameRecorded(uint16_t game);
+
+// Games recorded since the store was set up
+uint32_t scoreGamesPlayed(void);
+
+// High score of a rank, 0 being the best (0 if there is none yet)
+uint16_t scoreHighScore(uint8_t rank);
+
+// Games that passed a level (1 to SCORE_LEVELS)
+uint32_t scoreLevelSuccesses(uint16_t level);
+
+// Sends the whole store as a TELEMETRY_SCORE_STORE frame, by DMA straight
+// from FRAM. The store must not change until it is out (uartBlockBusy).
+uint8_t scoreSendStore(void);
+
+#endif
@@ -0,0 +1,85 @@
+/******************************************************************************
+ *
+ * FILE: sequence.c
+ *
+ * DESCRIPTION:
+ *   Stores and generates the LED sequence the player has to repeat.
+ *   - Each step is one bit, packed eight to a byte in an FRAM buffer.
+ *   - New steps are produced a byte at a time by a 16-bit xorshift PRNG,
+ *     only when a round actually needs them.
+ *   - Playback and input checking walk the sequence with a cursor, which
+ *     only shifts a one-bit mask per step. The MSP430 has no barrel
+ *     shifter, so this avoids a shift loop for every step.
+ *
+ * CREATED BY:
+ *   Hanna Szalai & Haroun Riahi
+ *
+ ******************************************************************************/
+
+#include <driverlib.h>
+#include "sequence.h"
+
+#define SEQUENCE_BYTES  (SEQUENCE_MAX_STEPS / 8)
+
+// Bit-packed sequence, kept in FRAM so it does not use up the 2 KB of RAM
+#pragma PERSISTENT(sequenceBits)
+uint8_t sequenceBits[SEQUENCE_BYTES] = {0};
+
+// Number of bytes of the sequence generated so far
+static uint16_t generatedBytes = 0;
+
+// xorshift state, must never be 0
+static uint16_t randomState = 1;
+
+// 16-bit xorshift (7, 9, 8), period 65535
+static uint16_t nextRandom(void)
+{
+    randomState ^= randomState << 7;
+    randomState ^= randomState >> 9;
+    randomState ^= randomState << 8;
+    return randomState;
+}
+
+void startSequence(uint16_t seed)
+{
+    randomState = seed ? seed : 0xACE1;
+    generatedBytes = 0;
+}
+
+void extendSequence(uint16_t steps)
+{
+    uint16_t neededBytes = (steps + 7) / 8;
+
+    if (neededBytes > SEQUENCE_BYTES)
+    {
+        neededBytes = SEQUENCE_BYTES;
+    }
+
+    while (generatedBytes < neededBytes)
+    {
+        sequenceBits[generatedBytes++] = (uint8_t)nextRandom();
+    }
+}
+
+void startCursor(SequenceCursor *cursor)
+{
+    cursor->byte = sequenceBits;
+    cursor->mask = 0x01;
+}
+
+uint8_t readCursor(const SequenceCursor *cursor)
+{
+    return (*cursor->byte & cursor->mask) ? STEP_GREEN : STEP_RED;
+}
+
+void advanceCursor(SequenceCursor *cursor)
+{
+    cursor->mask <<= 1;
+
+    // Stepped past bit 7, move on to bit 0 of the next byte
+    if (cursor->mask == 0)
+    {
+        cursor->mask = 0x01;
+        cursor->byte++;
+    }
+}
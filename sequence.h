@@ -0,0 +1,52 @@
+/******************************************************************************
+ *
+ * FILE: sequence.h
+ *
+ * PURPOSE:
+ *   Declares the game sequence engine. The red/green sequence is stored
+ *   bit-packed in FRAM (one bit per step, 0 = red, 1 = green) and filled
+ *   lazily from a xorshift PRNG as rounds advance, so games are no longer
+ *   limited to the 16 steps of a single int.
+ *
+ * CREATED BY:
+ *   Hanna Szalai & Haroun Riahi
+ *
+ ******************************************************************************/
+
+#ifndef LCD_SEQUENCE_H_
+#define LCD_SEQUENCE_H_
+
+#include "stdint.h"
+
+// Longest sequence a game can reach (one bit each, 512 bytes of FRAM)
+#define SEQUENCE_MAX_STEPS  4096
+
+// LED colour stored for each step
+#define STEP_RED    0
+#define STEP_GREEN  1
+
+// Starts a new, empty sequence from the given seed (0 is replaced)
+void startSequence(uint16_t seed);
+
+// Makes sure at least the first 'steps' steps have been generated
+void extendSequence(uint16_t steps);
+
+// Walks the sequence one step at a time. Moving to the next step is just a
+// one-bit mask shift, so going through N steps costs O(N) in total instead
+// of the O(N^2) shift work of computing (pattern >> step) for every step.
+typedef struct
+{
+    const uint8_t *byte;    // Byte holding the current step
+    uint8_t mask;           // Bit of the current step in that byte
+} SequenceCursor;
+
+// Points the cursor at step 0
+void startCursor(SequenceCursor *cursor);
+
+// Returns STEP_RED or STEP_GREEN for the step under the cursor
+uint8_t readCursor(const SequenceCursor *cursor);
+
+// Moves the cursor to the next step
+void advanceCursor(SequenceCursor *cursor);
+
+#endif
@@ -0,0 +1,188 @@
+/******************************************************************************
+ *
+ * FILE: telemetry.c
+ *
+ * DESCRIPTION:
+ *   Binary telemetry frames over the UART (layout in telemetry.h).
+ *   - Each frame is put together in a buffer on the stack and queued with
+ *     a single uartWrite, so it never gets split by other output. When the
+ *     UART buffer is full the whole frame is dropped.
+ *   - The CRC16 comes from the CRC module (CRC-CCITT, seeded with
+ *     TELEMETRY_CRC_SEED). Bytes written with CRC_set8BitData go in
+ *     LSB first; host/telemetryDecode.c does the same in software.
+ *   - The sync byte lets the decoder find the next frame again after a
+ *     corrupt one or after the text lines in between.
+ *   - A block frame is queued as three parts in order: the header with
+ *     uartWrite, the block with uartSendBlock and the CRC with uartWrite.
+ *     The UART keeps them in that order and sends the block by DMA.
+ *
+ * CREATED BY:
+ *   Hanna Szalai & Haroun Riahi
+ *
+ ******************************************************************************/
+
+#include <driverlib.h>
+#include <stdint.h>
+#include "telemetry.h"
+#include "scheduler.h"
+#include "uart.h"
+#include "reactionTimer.h"
+
+// Offsets in a frame
+#define FRAME_LENGTH    1
+#define FRAME_TYPE      2
+#define FRAME_PAYLOAD   3
+
+typedef struct
+{
+    uint8_t bytes[TELEMETRY_MAX_PAYLOAD + TELEMETRY_OVERHEAD];
+    uint8_t end;            // Next free byte
+} Frame;
+
+static void put8(Frame *frame, uint8_t value)
+{
+    frame->bytes[frame->end++] = value;
+}
+
+static void put16(Frame *frame, uint16_t value)
+{
+    put8(frame, (uint8_t)value);
+    put8(frame, (uint8_t)(value >> 8));
+}
+
+static void put32(Frame *frame, uint32_t value)
+{
+    put16(frame, (uint16_t)value);
+    put16(frame, (uint16_t)(value >> 16));
+}
+
+// Starts a frame with its header and the time of the event
+static void startFrame(Frame *frame, uint8_t type, uint32_t timeMs)
+{
+    frame->end = 0;
+    put8(frame, TELEMETRY_SYNC);
+    put8(frame, 0);
+    put8(frame, type);
+    put32(frame, timeMs);
+}
+
+// Fills in the length and CRC and queues the frame
+static void sendFrame(Frame *frame)
+{
+    uint16_t crc;
+    uint8_t i;
+
+    frame->bytes[FRAME_LENGTH] = frame->end - FRAME_PAYLOAD;
+
+    CRC_setSeed(CRC_BASE, TELEMETRY_CRC_SEED);
+    for (i = FRAME_LENGTH; i < frame->end; i++)
+    {
+        CRC_set8BitData(CRC_BASE, frame->bytes[i]);
+    }
+    crc = CRC_getResult(CRC_BASE);
+    put16(frame, crc);
+
+    uartWrite(frame->bytes, frame->end);
+}
+
+uint32_t telemetryTimeMs(void)
+{
+    uint32_t ticks;
+
+    // The tick ISR can change tickCount between the reads of its two halves
+    do
+    {
+        ticks = tickCount;
+    } while (ticks != tickCount);
+
+    return ticks * (1000 / TICK_HZ);
+}
+
+uint32_t telemetryTimeOf(uint32_t reactionTime)
+{
+    return telemetryTimeMs() - reactionAgeMs(reactionTime);
+}
+
+void telemetryRoundStart(uint16_t round)
+{
+    Frame frame;
+
+    startFrame(&frame, TELEMETRY_ROUND_START, telemetryTimeMs());
+    put16(&frame, round);
+    sendFrame(&frame);
+}
+
+void telemetryPlayback(uint16_t round, uint16_t step, uint8_t colour, uint32_t shownMs)
+{
+    Frame frame;
+
+    startFrame(&frame, TELEMETRY_PLAYBACK, shownMs);
+    put16(&frame, round);
+    put16(&frame, step);
+    put8(&frame, colour);
+    sendFrame(&frame);
+}
+
+void telemetryPress(uint16_t round, uint16_t step, uint8_t colour,
+                    uint8_t correct, uint32_t pressMs)
+{
+    Frame frame;
+
+    startFrame(&frame, TELEMETRY_PRESS, pressMs);
+    put16(&frame, round);
+    put16(&frame, step);
+    put8(&frame, colour);
+    put8(&frame, correct != 0);
+    put32(&frame, reactionTimeUs(step));
+    put32(&frame, reactionHoldUs(step));
+    sendFrame(&frame);
+}
+
+uint8_t telemetrySendBlock(uint8_t type, const void *data, uint8_t length)
+{
+    const uint8_t *bytes = data;
+    Frame frame;
+    uint8_t crc[2];
+    uint16_t result;
+    uint8_t i;
+
+    if (uartBlockBusy())
+    {
+        return UART_BUSY;
+    }
+
+    startFrame(&frame, type, telemetryTimeMs());
+    frame.bytes[FRAME_LENGTH] = frame.end - FRAME_PAYLOAD + length;
+
+    CRC_setSeed(CRC_BASE, TELEMETRY_CRC_SEED);
+    for (i = FRAME_LENGTH; i < frame.end; i++)
+    {
+        CRC_set8BitData(CRC_BASE, frame.bytes[i]);
+    }
+    for (i = 0; i < length; i++)
+    {
+        CRC_set8BitData(CRC_BASE, bytes[i]);
+    }
+    result = CRC_getResult(CRC_BASE);
+    crc[0] = (uint8_t)result;
+    crc[1] = (uint8_t)(result >> 8);
+
+    if (uartWrite(frame.bytes, frame.end) != UART_OK)
+    {
+        return UART_OVERFLOW;
+    }
+    uartSendBlock(data, length, 0);
+
+    // A CRC that does not fit spoils the frame, and the decoder drops it
+    return uartWrite(crc, sizeof(crc));
+}
+
+void telemetryResult(uint16_t points, uint8_t won)
+{
+    Frame frame;
+
+    startFrame(&frame, TELEMETRY_RESULT, telemetryTimeMs());
+    put16(&frame, points);
+    put8(&frame, won != 0);
+    sendFrame(&frame);
+}
@@ -0,0 +1,84 @@
+/******************************************************************************
+ *
+ * FILE: telemetry.h
+ *
+ * PURPOSE:
+ *   Declares the binary telemetry stream sent over the UART next to the
+ *   text log. Every game event (round start, each LED of the playback,
+ *   each button press and the result) goes out as one small frame with a
+ *   timestamp, so a capture of the serial line can be turned into a table
+ *   of the whole game by host/telemetryDecode.c.
+ *
+ *   Frame layout (multi-byte fields little-endian):
+ *     TELEMETRY_SYNC | length | type | payload (length bytes) | CRC16
+ *   The CRC16 is worked out by the CRC module over length, type and
+ *   payload, from the seed TELEMETRY_CRC_SEED. Every payload starts with
+ *   the time of the event in milliseconds since the scheduler started.
+ *
+ *   Frames with a block of memory as their payload (the score store) can
+ *   be longer than TELEMETRY_MAX_PAYLOAD, up to the 255 bytes the length
+ *   byte allows. The block goes out by DMA straight from where it is kept.
+ *
+ * CREATED BY:
+ *   Hanna Szalai & Haroun Riahi
+ *
+ ******************************************************************************/
+
+#ifndef LCD_TELEMETRY_H_
+#define LCD_TELEMETRY_H_
+
+#include "stdint.h"
+
+#define TELEMETRY_SYNC          0xA5
+#define TELEMETRY_CRC_SEED      0xFFFF
+
+// Bytes around the payload: sync, length, type and the two CRC bytes
+#define TELEMETRY_OVERHEAD      5
+#define TELEMETRY_MAX_PAYLOAD   24
+
+// Frame types and their payloads after the 32-bit time
+#define TELEMETRY_ROUND_START   0x01    // round (16 bit)
+#define TELEMETRY_PLAYBACK      0x02    // round, step (16 bit), colour
+#define TELEMETRY_PRESS         0x03    // round, step (16 bit), colour, correct,
+                                        // reaction and hold time (32 bit, us)
+#define TELEMETRY_RESULT        0x04    // points (16 bit), won
+#define TELEMETRY_SCORE_STORE   0x05    // the score store as kept in FRAM:
+                                        // magic (16 bit), high scores
+                                        // (SCORE_TABLE_SIZE x 16 bit), games
+                                        // played (32 bit), games by points
+                                        // (SCORE_LEVELS + 1 x 32 bit)
+
+// Longest payload of a frame, time included
+#define TELEMETRY_MAX_LENGTH    255
+
+// A round is about to be played back (rounds count from 0)
+void telemetryRoundStart(uint16_t round);
+
+// One LED of the playback is lit at shownMs (colour is STEP_RED or
+// STEP_GREEN). The step is sent when it is queued, before it is shown.
+void telemetryPlayback(uint16_t round, uint16_t step, uint8_t colour, uint32_t shownMs);
+
+// The player pressed the button of a colour for a step; pressMs is when
+// the press started, correct is non-zero if it was the right colour. The
+// reaction and hold times come from the reaction timer, where the step is
+// also the number of the press in the round.
+void telemetryPress(uint16_t round, uint16_t step, uint8_t colour,
+                    uint8_t correct, uint32_t pressMs);
+
+// The game is over with this many points
+void telemetryResult(uint16_t points, uint8_t won);
+
+// Sends a frame whose payload after the time is a block of memory, up to
+// TELEMETRY_MAX_LENGTH - 4 bytes. Only the header and the CRC are queued
+// as bytes; the block is sent by DMA from where it is and must not change
+// until it is out. UART_BUSY or UART_OVERFLOW (uart.h) if it cannot go.
+uint8_t telemetrySendBlock(uint8_t type, const void *data, uint8_t length);
+
+// Milliseconds since the scheduler started, as used in the frames
+uint32_t telemetryTimeMs(void);
+
+// The same time of a reaction timer count, such as the edge time of a
+// button event (getButtonEventTime), however long ago it was taken
+uint32_t telemetryTimeOf(uint32_t reactionTime);
+
+#endif
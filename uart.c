@@ -0,0 +1,332 @@
+/******************************************************************************
+ *
+ * FILE: uart.c
+ *
+ * DESCRIPTION:
+ *   Interrupt-driven UART output on eUSCI_A1.
+ *   - uartPrint copies the text into a ring buffer and enables the
+ *     transmit interrupt, then returns straight away.
+ *   - Each time TXBUF is free the interrupt moves the next byte into it.
+ *     When the buffer runs empty it switches itself off again.
+ *   - A full buffer drops the new text and counts the bytes, instead of
+ *     waiting for room.
+ *   - uartSendBlock hands a large block to DMA channel 0. It notes where
+ *     the ring's head is, and when the interrupt has sent the text up to
+ *     there it writes the first byte of the block itself. Every following
+ *     UCTXIFG edge makes the DMA move the next one, so the CPU does
+ *     nothing per byte. The DMA interrupt reports the end and lets the
+ *     interrupt go on with the text queued after the block.
+ *
+ *   The eUSCI requests SMCLK while it has something to send, so output
+ *   keeps going while the game loop sleeps in LPM3. Timer_A0 runs from
+ *   SMCLK too and counts on through those sleeps; the scheduler leaves
+ *   them out of the active time, and the ISRs here tell it when they run
+ *   (activeTimeIsrStart/End). uartFlush sleeps through enterSleep for the
+ *   same reason. The baud rate settings
+ *   are worked out (uartBaud.c) from whatever SMCLK initializeClocks has
+ *   set up, and uartSetBaud can change the rate later.
+ *
+ * CREATED BY:
+ *   Hanna Szalai & Haroun Riahi
+ *
+ ******************************************************************************/
+
+#include <driverlib.h>
+#include <stdint.h>
+#include <string.h>
+#include "uart.h"
+#include "clockConfig.h"
+#include "scheduler.h"
+#include "profiler.h"
+
+// DMA channel and trigger (UCA1TXIFG) used for blocks
+#define UART_DMA_CHANNEL        DMA_CHANNEL_0
+#define UART_DMA_TRIGGER        DMA_TRIGGERSOURCE_17
+
+// Bus address of a byte for the DMA registers. The register model maps
+// host pointers to addresses of its own instead (host/msp430.h).
+#ifndef DMA_ADDRESS
+#define DMA_ADDRESS(pointer)    ((uint32_t)(uintptr_t)(pointer))
+#endif
+
+static char txBuffer[UART_TX_BUFFER_SIZE];
+static volatile uint16_t txHead = 0;      // Next free slot, moved by uartWrite
+static volatile uint16_t txTail = 0;      // Next byte to send, moved by the ISR
+static volatile uint8_t flushWaiting = 0;
+static uint32_t droppedBytes = 0;
+
+static const uint8_t *blockData;
+static uint16_t blockAt;                  // Ring position the block goes out at
+static volatile uint16_t blockLength = 0; // Non-zero while a block is queued or sent
+static volatile uint8_t blockStarted = 0; // The DMA has the transmitter
+static void (*blockDone)(void) = 0;
+
+void uart_init(void) {
+    DMA_initParam dmaParam = {0};
+    UartBaudSetting baud;
+
+    // Unlock GPIO configuration
+    PM5CTL0 &= ~LOCKLPM5;
+
+    // Configure UART pins P3.4 (TX) and P3.5 (RX)
+    P3SEL0 |= BIT4 | BIT5;
+    P3SEL1 &= ~(BIT4 | BIT5);
+
+    // Configure UART
+    UCA1CTLW0 = UCSWRST;          // Put eUSCI in reset
+    UCA1CTLW0 |= UCSSEL__SMCLK;   // Use SMCLK
+
+    // Baud rate dividers for the SMCLK initializeClocks set up. An SMCLK
+    // too slow for them also shows up in clockShortfall.
+    if (uartComputeBaud(clockRequest(CLOCK_SMCLK, UART_CLOCK_MIN_HZ), UART_BAUD, &baud) == UART_OK)
+    {
+        UCA1BRW = baud.brw;
+        UCA1MCTLW = baud.mctlw;
+    }
+
+    // Clear reset to initialize UART
+    UCA1CTLW0 &= ~UCSWRST;
+
+    // DMA channel for blocks: one byte into TXBUF per UCTXIFG rising edge.
+    // The source and length are set for each block.
+    dmaParam.channelSelect = UART_DMA_CHANNEL;
+    dmaParam.transferModeSelect = DMA_TRANSFER_SINGLE;
+    dmaParam.transferSize = 1;
+    dmaParam.triggerSourceSelect = UART_DMA_TRIGGER;
+    dmaParam.transferUnitSelect = DMA_SIZE_SRCBYTE_DSTBYTE;
+    dmaParam.triggerTypeSelect = DMA_TRIGGER_RISINGEDGE;
+    DMA_init(&dmaParam);
+    DMA_setDstAddress(UART_DMA_CHANNEL,
+                      EUSCI_A_UART_getTransmitBufferAddress(EUSCI_A1_BASE),
+                      DMA_DIRECTION_UNCHANGED);
+    DMA_clearInterrupt(UART_DMA_CHANNEL);
+    DMA_enableInterrupt(UART_DMA_CHANNEL);
+
+    txHead = 0;
+    txTail = 0;
+    blockLength = 0;
+    blockStarted = 0;
+}
+
+uint8_t uartSetBaud(uint32_t baud)
+{
+    UartBaudSetting setting;
+
+    if (uartComputeBaud(CS_getSMCLK(), baud, &setting) != UART_OK)
+    {
+        return UART_BAUD_ERROR;
+    }
+
+    // The last byte must be out before the eUSCI goes into reset
+    uartFlush();
+    UCA1CTLW0 |= UCSWRST;
+    UCA1BRW = setting.brw;
+    UCA1MCTLW = setting.mctlw;
+    UCA1CTLW0 &= ~UCSWRST;
+
+    return UART_OK;
+}
+
+uint8_t uartWrite(const void *data, uint16_t length)
+{
+    const uint8_t *bytes = data;
+    uint16_t head = txHead;
+    uint16_t interruptState;
+    uint16_t space = (txTail - head - 1) & (UART_TX_BUFFER_SIZE - 1);
+
+    if (length > space)
+    {
+        droppedBytes += length;
+        return UART_OVERFLOW;
+    }
+
+    while (length--)
+    {
+        txBuffer[head] = *bytes++;
+        head = (head + 1) & (UART_TX_BUFFER_SIZE - 1);
+    }
+    txHead = head;
+
+    // If TXBUF is empty the interrupt fires right away and starts sending.
+    // While the DMA has the transmitter its interrupt does this instead.
+    // The interrupt can hand TXBUF to a block between the check and the
+    // enable, so both are done with interrupts off.
+    interruptState = __get_interrupt_state();
+    __disable_interrupt();
+    if (!blockStarted)
+    {
+        UCA1IE |= UCTXIE;
+    }
+    __set_interrupt_state(interruptState);
+
+    return UART_OK;
+}
+
+uint8_t uartPrint(const char *str)
+{
+    return uartWrite(str, strlen(str));
+}
+
+// Prints an unsigned number in decimal over UART
+uint8_t uartPrintNumber(unsigned long value)
+{
+    char text[11];
+    int pos = 10;
+
+    text[pos] = '\0';
+    do
+    {
+        text[--pos] = (value % 10) + '0';
+        value /= 10;
+    } while (value);
+
+    return uartPrint(&text[pos]);
+}
+
+uint8_t uartSendBlock(const void *data, uint16_t length, void (*done)(void))
+{
+    if (blockLength)
+    {
+        return UART_BUSY;
+    }
+    if (!length)
+    {
+        if (done)
+        {
+            done();
+        }
+        return UART_OK;
+    }
+
+    blockData = data;
+    blockDone = done;
+    blockStarted = 0;
+    blockAt = txHead;
+    blockLength = length;
+
+    // The transmit interrupt starts the block once the text queued before
+    // it is out
+    UCA1IE |= UCTXIE;
+
+    return UART_OK;
+}
+
+uint8_t uartBlockBusy(void)
+{
+    return blockLength != 0;
+}
+
+void uartFlush(void)
+{
+    __disable_interrupt();
+    while (txHead != txTail || blockLength)
+    {
+        // The ISRs wake us when they have taken the last byte
+        flushWaiting = 1;
+        enterSleep();
+    }
+    flushWaiting = 0;
+    __enable_interrupt();
+
+    // Let the last byte leave the shift register
+    while (UCA1STATW & UCBUSY);
+}
+
+uint32_t uartDroppedBytes(void)
+{
+    return droppedBytes;
+}
+
+// Called from the ISRs when the last byte of the block is in TXBUF
+static void finishBlock(void)
+{
+    void (*done)(void) = blockDone;
+
+    blockStarted = 0;
+    blockLength = 0;
+    blockDone = 0;
+
+    // Text queued while the DMA was busy
+    if (txHead != txTail)
+    {
+        UCA1IE |= UCTXIE;
+    }
+
+    if (done)
+    {
+        done();
+    }
+}
+
+// Gives TXBUF to the DMA. Called with TXBUF free, so the first byte goes
+// in by hand and its UCTXIFG edge triggers the DMA for the second one.
+static void startBlock(void)
+{
+    blockStarted = 1;
+
+    if (blockLength > 1)
+    {
+        DMA_setSrcAddress(UART_DMA_CHANNEL, DMA_ADDRESS(blockData + 1),
+                          DMA_DIRECTION_INCREMENT);
+        DMA_setTransferSize(UART_DMA_CHANNEL, blockLength - 1);
+        DMA_enableTransfers(UART_DMA_CHANNEL);
+    }
+
+    UCA1TXBUF = blockData[0];
+
+    if (blockLength == 1)
+    {
+        finishBlock();
+    }
+}
+
+// eUSCI_A1 Interrupt Service Routine (TXBUF free)
+#pragma vector=USCI_A1_VECTOR
+__interrupt void USCI_A1_ISR (void)
+{
+    uint16_t tail = txTail;
+
+    activeTimeIsrStart();
+    PROFILE_START(PROBE_UART_ISR);
+    if (blockLength && !blockStarted && tail == blockAt)
+    {
+        startBlock();
+    }
+    else if (!blockStarted && tail != txHead)
+    {
+        // Never write TXBUF while the DMA owns it
+        UCA1TXBUF = txBuffer[tail];
+        tail = (tail + 1) & (UART_TX_BUFFER_SIZE - 1);
+        txTail = tail;
+    }
+
+    if (blockStarted || (tail == txHead && !blockLength))
+    {
+        // The DMA has the transmitter, or nothing is left to send: stop the
+        // interrupt until the block is done or uartWrite adds more
+        UCA1IE &= ~UCTXIE;
+        if (flushWaiting && !blockLength)
+        {
+            __bic_SR_register_on_exit(LPM3_bits);
+        }
+    }
+    PROFILE_STOP(PROBE_UART_ISR);
+    activeTimeIsrEnd();
+}
+
+// DMA Interrupt Service Routine (a block has been moved into TXBUF)
+#pragma vector=DMA_VECTOR
+__interrupt void DMA_ISR (void)
+{
+    activeTimeIsrStart();
+    PROFILE_START(PROBE_DMA_ISR);
+    DMA_clearInterrupt(UART_DMA_CHANNEL);
+    finishBlock();
+
+    if (flushWaiting && txHead == txTail)
+    {
+        __bic_SR_register_on_exit(LPM3_bits);
+    }
+    PROFILE_STOP(PROBE_DMA_ISR);
+    activeTimeIsrEnd();
+}
@@ -0,0 +1,88 @@
+/******************************************************************************
+ *
+ * FILE: uart.h
+ *
+ * PURPOSE:
+ *   Declares the interrupt-driven UART transmitter on eUSCI_A1 (9600 baud,
+ *   backchannel UART of the LaunchPad). Text is copied into a ring buffer
+ *   and sent by the transmit interrupt, so printing never makes the game
+ *   loop wait for the serial line. Large blocks are sent by DMA straight
+ *   from where they are stored, without copying and without the CPU.
+ *
+ * CREATED BY:
+ *   Hanna Szalai & Haroun Riahi
+ *
+ ******************************************************************************/
+
+#ifndef LCD_UART_H_
+#define LCD_UART_H_
+
+#include "stdint.h"
+
+// Must be a power of two
+#define UART_TX_BUFFER_SIZE     256
+
+// Line speed, and the slowest SMCLK that can oversample it 16 times
+#define UART_BAUD               9600
+#define UART_CLOCK_MIN_HZ       (16UL * UART_BAUD)
+
+// Largest transmit bit error a baud setting may have, in thousandths of a
+// bit. The receiver samples in the middle of each bit, so this leaves
+// room for the error of its own clock.
+#define UART_MAX_BIT_ERROR      100
+
+// Results of uartWrite, uartPrint, uartSendBlock and the baud functions
+#define UART_OK                 0
+#define UART_OVERFLOW           1
+#define UART_BUSY               2
+#define UART_BAUD_ERROR         3
+
+// eUSCI_A register values for one clock and baud rate
+typedef struct
+{
+    uint16_t brw;               // UCAxBRW (UCBRx)
+    uint16_t mctlw;             // UCAxMCTLW (UCOS16, UCBRFx, UCBRSx)
+    uint16_t maxError;          // Worst transmit bit error, thousandths of a bit
+} UartBaudSetting;
+
+// Sets up eUSCI_A1 on P3.4/P3.5 for UART_BAUD, from the SMCLK set up by
+// initializeClocks
+void uart_init(void);
+
+// Works out the settings for a baud rate from a BRCLK frequency
+// (uartBaud.c). UART_BAUD_ERROR if the clock is too slow for the rate or
+// the bit error would be over UART_MAX_BIT_ERROR.
+uint8_t uartComputeBaud(uint32_t clockHz, uint32_t baud, UartBaudSetting *setting);
+
+// Waits for queued output to go out, then switches to another baud rate.
+// UART_BAUD_ERROR, with the old rate kept, if SMCLK cannot make it.
+uint8_t uartSetBaud(uint32_t baud);
+
+// Queues bytes for sending and returns at once. If they do not all fit
+// in the buffer nothing is queued and UART_OVERFLOW is returned, so a log
+// line is never cut in half.
+uint8_t uartWrite(const void *data, uint16_t length);
+
+// Queues a string, same as uartWrite
+uint8_t uartPrint(const char *str);
+
+// Queues an unsigned number in decimal
+uint8_t uartPrintNumber(unsigned long value);
+
+// Queues a block of RAM or FRAM to be sent by DMA, after the text queued
+// before it and before the text queued after it. The block is not
+// copied, so it must stay as it is until done is called (from the DMA
+// interrupt; done may be 0). Only one block at a time: UART_BUSY if
+// another one is still going.
+uint8_t uartSendBlock(const void *data, uint16_t length, void (*done)(void));
+
+// Non-zero while a block is queued or being sent
+uint8_t uartBlockBusy(void);
+
+// Sleeps until everything queued, blocks too, has left the transmitter
+void uartFlush(void);
+
+// Bytes thrown away because the buffer was full
+uint32_t uartDroppedBytes(void);
+
+#endif
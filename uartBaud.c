@@ -0,0 +1,133 @@
+/******************************************************************************
+ *
+ * FILE: uartBaud.c
+ *
+ * DESCRIPTION:
+ *   Works out the eUSCI_A baud rate settings for any BRCLK and baud rate,
+ *   the way the FR6989 user's guide describes it:
+ *   - N = fBRCLK / baud. With N of 16 or more the eUSCI oversamples:
+ *     UCBRx = INT(N / 16) and UCBRFx = INT(fraction of N / 16 x 16).
+ *     Below 16, UCBRx = INT(N) without oversampling.
+ *   - UCBRSx adds one BRCLK to the bits its pattern marks, to make up the
+ *     fraction of N that is left. The user's guide lists a pattern for
+ *     each fraction; every one of them is tried and the one with the
+ *     smallest error is kept.
+ *   - The error is the transmit timing error of the user's guide: how far
+ *     the end of each bit of a frame is from where it should be. Patterns
+ *     are compared in whole BRCLK x baud units; only the winner is divided
+ *     down to a fraction of a bit.
+ *
+ *   No hardware is touched, so the same code runs in host/baudTable.c.
+ *
+ * CREATED BY:
+ *   Hanna Szalai & Haroun Riahi
+ *
+ ******************************************************************************/
+
+#include "uart.h"
+
+// Start bit, 8 data bits and the stop bit
+#define FRAME_BITS      10
+
+// Bits of UCAxMCTLW
+#define MCTLW_OS16      0x0001
+#define MCTLW_BRF_SHIFT 4
+#define MCTLW_BRS_SHIFT 8
+
+// Without oversampling the receiver's three samples need 3 BRCLKs a bit
+#define MIN_DIVIDER     3
+
+// UCBRSx patterns of the user's guide, one for each fraction of N
+static const uint8_t modulationPatterns[] =
+{
+    0x00, 0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x11, 0x21, 0x22, 0x44, 0x25,
+    0x49, 0x4A, 0x52, 0x92, 0x53, 0x55, 0xAA, 0x6B, 0xAD, 0xB5, 0xB6, 0xD6,
+    0xB7, 0xBB, 0xDD, 0xED, 0xEE, 0xBF, 0xDF, 0xEF, 0xF7, 0xFB, 0xFD, 0xFE
+};
+
+// Worst transmit error of a frame, in BRCLKs times baud. The end of bit i
+// should be (i + 1) x fBRCLK / baud BRCLKs after the start edge; each bit
+// really takes bitClocks, plus one when its bit of UCBRSx is set (the
+// pattern starts at its LSB with the start bit). Multiplying both sides
+// by baud keeps everything whole, and both only grow by a fixed amount a
+// bit, so the frame is timed with additions alone.
+static uint64_t frameError(uint32_t clockHz, uint32_t baud, uint32_t bitClocks,
+                           uint8_t pattern)
+{
+    uint64_t bitTime = (uint64_t)bitClocks * baud;
+    uint64_t elapsed = 0;
+    uint64_t ideal = 0;
+    uint64_t difference;
+    uint64_t worst = 0;
+    uint8_t bit;
+
+    for (bit = 0; bit < FRAME_BITS; bit++)
+    {
+        elapsed += bitTime;
+        if ((pattern >> (bit % 8)) & 1)
+        {
+            elapsed += baud;
+        }
+        ideal += clockHz;
+
+        difference = elapsed > ideal ? elapsed - ideal : ideal - elapsed;
+        if (difference > worst)
+        {
+            worst = difference;
+        }
+    }
+
+    return worst;
+}
+
+uint8_t uartComputeBaud(uint32_t clockHz, uint32_t baud, UartBaudSetting *setting)
+{
+    uint32_t divider;
+    uint32_t bitClocks;
+    uint16_t brf = 0;
+    uint64_t error;
+    uint64_t bestError = 0;
+    uint8_t i;
+
+    if (!baud || clockHz / baud < MIN_DIVIDER)
+    {
+        return UART_BAUD_ERROR;
+    }
+
+    divider = clockHz / baud;
+    if (divider / 16 > 0xFFFF)
+    {
+        return UART_BAUD_ERROR;
+    }
+
+    // The integer part of N is 16 x UCBRx + UCBRFx with oversampling
+    bitClocks = divider;
+    if (divider >= 16)
+    {
+        setting->brw = (uint16_t)(divider / 16);
+        brf = (uint16_t)(divider % 16);
+    }
+    else
+    {
+        setting->brw = (uint16_t)divider;
+    }
+
+    for (i = 0; i < sizeof(modulationPatterns); i++)
+    {
+        error = frameError(clockHz, baud, bitClocks, modulationPatterns[i]);
+        if (i == 0 || error < bestError)
+        {
+            bestError = error;
+            setting->mctlw = ((uint16_t)modulationPatterns[i] << MCTLW_BRS_SHIFT)
+                             | (brf << MCTLW_BRF_SHIFT)
+                             | (divider >= 16 ? MCTLW_OS16 : 0);
+        }
+    }
+
+    // Only the best pattern is turned into thousandths of a bit: divided
+    // by baud for BRCLKs, and by fBRCLK / baud for bits
+    bestError = (bestError * 1000 + clockHz / 2) / clockHz;
+    setting->maxError = bestError > 0xFFFF ? 0xFFFF : (uint16_t)bestError;
+
+    return setting->maxError <= UART_MAX_BIT_ERROR ? UART_OK : UART_BAUD_ERROR;
+}